@@ -0,0 +1,210 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "Chip8.h"
+#include "FrameHash.h"
+#include "ROMCache.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+//  The outcome of running a single ROM.
+struct BatchJob
+{
+    std::string romPath;
+    uint64_t videoHash{};
+    uint64_t cycles{};
+    double seconds{};
+    std::string error;
+};
+
+//  The directory the profiles of the jobs are written to, when profiling is compiled in.
+static std::string profileDirectory;
+
+void RunJob(BatchJob &job, Chip8Engine engine, uint64_t cycles, uint32_t instructionsPerFrame, uint64_t seed);
+void CollectROMs(const char *path, std::vector<BatchJob> &jobs);
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        printf("Usage: %s <Cycles> <ROM or directory>... [--frames <Frames> <InstructionsPerFrame>] [--threads <Threads>] [--engine interpreter|threaded|jit|aot] [--seed <Seed>] [--profile <Directory>]\n", argv[0]);
+        abort();
+    }
+
+    uint64_t cycles = std::stoull(argv[1]);
+    uint32_t instructionsPerFrame = Chip8Constants::DEFAULT_INSTRUCTIONS_PER_FRAME;
+    size_t threads = 0;
+    uint64_t seed = 0;
+    Chip8Engine engine = Chip8Engine::Threaded;
+    std::vector<BatchJob> jobs;
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--frames") && i + 2 < argc)
+        {
+            instructionsPerFrame = std::stoul(argv[i + 2]);
+            cycles = std::stoull(argv[i + 1]) * instructionsPerFrame;
+            i += 2;
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+        {
+            threads = std::stoul(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--profile") && i + 1 < argc)
+        {
+            profileDirectory = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+        {
+            seed = std::stoull(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--engine") && i + 1 < argc)
+        {
+            std::string name = argv[++i];
+            engine = (name == "jit") ? Chip8Engine::JIT : (name == "aot") ? Chip8Engine::AOT : (name == "interpreter") ? Chip8Engine::Interpreter : Chip8Engine::Threaded;
+        }
+        else
+        {
+            CollectROMs(argv[i], jobs);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    {
+        ThreadPool pool(threads);
+
+        for (BatchJob &job : jobs)
+        {
+            pool.Submit([&job, engine, cycles, instructionsPerFrame, seed]
+                        { RunJob(job, engine, cycles, instructionsPerFrame, seed); });
+        }
+
+        pool.Wait();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    //  Reporting in the order the ROMs were given, no matter which worker ran them.
+    uint64_t totalCycles = 0;
+    size_t failed = 0;
+
+    printf("%-40s %18s %14s %12s\n", "ROM", "Framebuffer Hash", "Cycles", "Wall (ms)");
+
+    for (const BatchJob &job : jobs)
+    {
+        if (!job.error.empty())
+        {
+            printf("%-40s %18s %14s %12.3f  %s\n", job.romPath.c_str(), "-", "-", job.seconds * 1e3, job.error.c_str());
+            failed++;
+            continue;
+        }
+
+        printf("%-40s   %016llx %14llu %12.3f\n",
+               job.romPath.c_str(),
+               (unsigned long long)job.videoHash,
+               (unsigned long long)job.cycles,
+               job.seconds * 1e3);
+
+        totalCycles += job.cycles;
+    }
+
+    printf("%zu ROMs, %zu failed, %llu cycles in %.3f s (%.1f M cycles/s)\n",
+           jobs.size(),
+           failed,
+           (unsigned long long)totalCycles,
+           seconds,
+           totalCycles / seconds / 1e6);
+
+    return (failed == 0) ? 0 : 1;
+}
+
+/***
+ *  RunJob:
+ *      Runs a single ROM headlessly for the given budget and records the outcome in the job.
+ *
+ *  @param job      The job, holding the ROM path and receiving the outcome.
+ *  @param engine   The engine executing the ROM.
+ *  @param cycles   The amount of instructions to execute.
+ *  @param instructionsPerFrame The amount of instructions in each 60 Hz timer frame.
+ *  @param seed     The randomness seed, so the screen hashes are reproducible.
+ ***/
+void RunJob(BatchJob &job, Chip8Engine engine, uint64_t cycles, uint32_t instructionsPerFrame, uint64_t seed)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    try
+    {
+        //  A `Chip8` runs a missing file as empty memory, which would be reported as a result.
+        if (ROMCache::Instance().Load(job.romPath.c_str()) == nullptr)
+        {
+            throw std::runtime_error("Could not open the ROM.");
+        }
+
+        std::unique_ptr<Chip8> chip8(new Chip8(job.romPath.c_str(), engine));
+
+        chip8->Seed(seed);
+        chip8->SetInstructionsPerFrame(instructionsPerFrame);
+        chip8->Run(cycles);
+
+        job.cycles = cycles;
+        job.videoHash = HashFrame(chip8->video);
+
+#ifdef CHIP8_PROFILE
+        //  Naming each profile after its ROM file.
+        if (!profileDirectory.empty())
+        {
+            std::filesystem::path profilePath = std::filesystem::path(profileDirectory) / std::filesystem::path(job.romPath).filename();
+            chip8->DumpProfile((profilePath.string() + ".json").c_str());
+        }
+#endif
+    }
+    catch (const std::exception &exception)
+    {
+        job.error = exception.what();
+    }
+
+    job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/***
+ *  CollectROMs:
+ *      Adds a job for the given ROM, or for every file in the given directory in name order.
+ *
+ *  @param path The path of a ROM or of a directory of ROMs.
+ *  @param jobs The jobs to add to.
+ ***/
+void CollectROMs(const char *path, std::vector<BatchJob> &jobs)
+{
+    std::vector<std::string> paths;
+
+    if (std::filesystem::is_directory(path))
+    {
+        for (const auto &entry : std::filesystem::directory_iterator(path))
+        {
+            if (entry.is_regular_file())
+            {
+                paths.push_back(entry.path().string());
+            }
+        }
+
+        std::sort(paths.begin(), paths.end());
+    }
+    else
+    {
+        paths.push_back(path);
+    }
+
+    for (const std::string &romPath : paths)
+    {
+        BatchJob job;
+        job.romPath = romPath;
+        jobs.push_back(job);
+    }
+}
@@ -0,0 +1,95 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "BeamSearch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+/***
+ *  Constructor:
+ *      Sets up a search running on the given pool.
+ *
+ *  @param pool          The workers advancing the states.
+ *  @param score         The callback scoring a state, higher is better.
+ *  @param width         The amount of states kept after every step.
+ *  @param cyclesPerStep The amount of instructions each input is held for.
+ ***/
+BeamSearch::BeamSearch(ThreadPool &pool, Chip8Score score, size_t width, uint64_t cyclesPerStep) : pool(pool),
+                                                                                                    score(score),
+                                                                                                    width(width),
+                                                                                                    cyclesPerStep(cyclesPerStep)
+{
+    //  An empty beam would leave no state to return.
+    if (width == 0)
+    {
+        throw std::invalid_argument("A beam must keep at least one state.");
+    }
+}
+
+/***
+ *  Search:
+ *      Expands every state of the beam with every input in parallel,
+ *      then keeps the best scored states for the next step.
+ *
+ *  @param start The state the search starts from.
+ *  @param depth The amount of steps to search.
+ *
+ *  @return      The inputs leading to the best scored state of the last step.
+ ***/
+BeamPath BeamSearch::Search(const Chip8 &start, size_t depth)
+{
+    std::vector<Candidate> beam(1);
+    beam[0].chip = start.Fork();
+    beam[0].path.score = this->score(start);
+
+    for (size_t step = 0; step < depth; step++)
+    {
+        std::vector<Candidate> children(beam.size() * BeamSearchConstants::AMOUNT_OF_INPUTS);
+
+        for (size_t parent = 0; parent < beam.size(); parent++)
+        {
+            for (uint8_t key = 0; key < BeamSearchConstants::AMOUNT_OF_INPUTS; key++)
+            {
+                Candidate &child = children[parent * BeamSearchConstants::AMOUNT_OF_INPUTS + key];
+                const Candidate &from = beam[parent];
+
+                this->pool.Submit([this, &from, key, &child]
+                                  { this->Expand(from, key, child); });
+            }
+        }
+
+        this->pool.Wait();
+
+        //  Ties keep their expansion order, so a search is repeatable.
+        std::stable_sort(children.begin(), children.end(), [](const Candidate &a, const Candidate &b)
+                         { return a.path.score > b.path.score; });
+
+        children.resize(std::min(children.size(), this->width));
+        beam = std::move(children);
+    }
+
+    return beam[0].path;
+}
+
+/***
+ *  Expand:
+ *      Forks the parent state, holds the key for a step, and scores the state it reached.
+ *
+ *  @param parent   The state to expand.
+ *  @param key      The key to hold, `NO_KEY` for none.
+ *  @param child    Receives the new state and its inputs.
+ ***/
+void BeamSearch::Expand(const Candidate &parent, uint8_t key, Candidate &child) const
+{
+    child.chip = parent.chip->Fork();
+
+    child.chip->SetKeypadMask((key != BeamSearchConstants::NO_KEY) ? (1u << key) : 0u);
+
+    child.chip->Run(this->cyclesPerStep);
+
+    child.path.keys = parent.path.keys;
+    child.path.keys.push_back(key);
+    child.path.score = this->score(*child.chip);
+}
@@ -0,0 +1,54 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "Chip8.h"
+#include "ThreadPool.h"
+
+#include <functional>
+#include <vector>
+
+namespace BeamSearchConstants
+{
+    //  The inputs tried at every step: holding one of the keys, or none of them.
+    constexpr uint8_t NO_KEY = Chip8Constants::AMOUNT_OF_CHARS;
+    constexpr uint8_t AMOUNT_OF_INPUTS = Chip8Constants::AMOUNT_OF_CHARS + 1;
+};
+
+//  Scores a machine state, higher is better.
+typedef std::function<double(const Chip8 &)> Chip8Score;
+
+//  A sequence of inputs and the score of the state it leads to.
+struct BeamPath
+{
+    std::vector<uint8_t> keys;
+    double score{};
+};
+
+class BeamSearch
+{
+private:
+    //  A state kept in the beam, with the inputs which led to it.
+    struct Candidate
+    {
+        std::unique_ptr<Chip8> chip;
+        BeamPath path;
+    };
+
+    ThreadPool &pool;
+    Chip8Score score;
+    size_t width;
+    uint64_t cyclesPerStep;
+
+    //  Forks the parent, holds the key for a step and scores the outcome.
+    void Expand(const Candidate &parent, uint8_t key, Candidate &child) const;
+
+public:
+    //  Every step holds a single key for the given amount of cycles, and keeps the best `width` states.
+    //  Throws invalid_argument for a width of 0.
+    BeamSearch(ThreadPool &pool, Chip8Score score, size_t width, uint64_t cyclesPerStep);
+
+    //  Searches the given amount of steps ahead of the start state, returns the best inputs found.
+    BeamPath Search(const Chip8 &start, size_t depth);
+};
@@ -0,0 +1,136 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "BeamSearch.h"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+
+static void printUsage(const char *program)
+{
+    printf("Usage: %s <ROM> [--depth <Steps>] [--width <States>] [--frames <FramesPerStep> <InstructionsPerFrame>] "
+           "[--threads <Threads>] [--score pixels|memory <Address>|register <X>]\n",
+           program);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printUsage(argv[0]);
+        abort();
+    }
+
+    size_t depth = 16;
+    size_t width = 32;
+    uint64_t framesPerStep = 6;
+    uint32_t instructionsPerFrame = Chip8Constants::DEFAULT_INSTRUCTIONS_PER_FRAME;
+    size_t threads = 0;
+
+    //  Lit pixels are the score, unless a memory address or a register holding the game score is given.
+    Chip8Score score = [](const Chip8 &chip)
+    {
+        double pixels = 0;
+
+        for (uint64_t row : chip.video)
+        {
+            pixels += __builtin_popcountll(row);
+        }
+
+        return pixels;
+    };
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--depth") && i + 1 < argc)
+        {
+            depth = std::stoul(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--width") && i + 1 < argc)
+        {
+            width = std::stoul(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--frames") && i + 2 < argc)
+        {
+            framesPerStep = std::stoull(argv[i + 1]);
+            instructionsPerFrame = std::stoul(argv[i + 2]);
+            i += 2;
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+        {
+            threads = std::stoul(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--score") && i + 1 < argc && !strcmp(argv[i + 1], "pixels"))
+        {
+            i++;
+        }
+        else if (!strcmp(argv[i], "--score") && i + 2 < argc && !strcmp(argv[i + 1], "memory"))
+        {
+            uint16_t address = std::stoul(argv[i + 2], nullptr, 0);
+            score = [address](const Chip8 &chip)
+            { return chip.ReadMemory(address); };
+            i += 2;
+        }
+        else if (!strcmp(argv[i], "--score") && i + 2 < argc && !strcmp(argv[i + 1], "register"))
+        {
+            uint8_t x = std::stoul(argv[i + 2], nullptr, 16);
+            score = [x](const Chip8 &chip)
+            { return chip.Register(x); };
+            i += 2;
+        }
+        else
+        {
+            printf("Unknown option `%s`.\n", argv[i]);
+            abort();
+        }
+    }
+
+    //  The beam keeps at least one state, the best one being the result.
+    if (width == 0)
+    {
+        printUsage(argv[0]);
+        abort();
+    }
+
+    Chip8 start(argv[1], Chip8Engine::Threaded);
+    start.SetInstructionsPerFrame(instructionsPerFrame);
+
+    ThreadPool pool(threads);
+    BeamSearch search(pool, score, width, framesPerStep * instructionsPerFrame);
+
+    auto begin = std::chrono::steady_clock::now();
+    BeamPath best = search.Search(start, depth);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    //  Every searched state advanced one step out of a state of the beam before it.
+    uint64_t states = 0;
+
+    for (size_t step = 0, beam = 1; step < depth; step++)
+    {
+        states += beam * BeamSearchConstants::AMOUNT_OF_INPUTS;
+        beam = std::min(beam * BeamSearchConstants::AMOUNT_OF_INPUTS, width);
+    }
+
+    printf("Best score %.3f after %zu steps of %llu frames:", best.score, depth, (unsigned long long)framesPerStep);
+
+    for (uint8_t key : best.keys)
+    {
+        if (key == BeamSearchConstants::NO_KEY)
+        {
+            printf(" -");
+        }
+        else
+        {
+            printf(" %X", key);
+        }
+    }
+
+    printf("\n%llu states on %zu threads in %.3f s (%.1f K states/s)\n",
+           (unsigned long long)states,
+           pool.Size(),
+           seconds,
+           states / seconds / 1e3);
+
+    return 0;
+}
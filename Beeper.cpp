@@ -0,0 +1,86 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "Beeper.h"
+
+/***
+ *  SetTone:
+ *      Queues a change of the tone, when the sound state differs from the last one queued.
+ *      A change dropped by a full queue is queued again on the next call.
+ *
+ *  @param on   Whether the sound timer is running.
+ *  @param time The host time of the state.
+ ***/
+void Beeper::SetTone(bool on, uint64_t time)
+{
+    if (on != this->reported && this->events.Push({time, on}))
+    {
+        this->reported = on;
+    }
+}
+
+/***
+ *  Fill:
+ *      Generates a buffer of the square wave tone. The buffer stands for the host time between the last call
+ *      and this one, so every change queued in that time starts at the sample in the same place of the buffer.
+ *      Changes queued after the given time are left to the next buffer.
+ *
+ *  @param samples  The buffer to write.
+ *  @param count    The amount of samples in the buffer.
+ *  @param now      The host time of the call.
+ ***/
+void Beeper::Fill(int16_t *samples, size_t count, uint64_t now)
+{
+    //  The first buffer has no previous call, its changes start it.
+    uint64_t start = (this->lastFill != 0 && this->lastFill < now) ? this->lastFill : now;
+    uint64_t span = now - start;
+    size_t sample = 0;
+
+    this->lastFill = now;
+
+    for (const ToneEvent *event = this->events.Front(); event != nullptr && event->time <= now; event = this->events.Front())
+    {
+        //  The sample the change falls on, earlier changes than the buffer start it.
+        size_t position = (span == 0 || event->time <= start) ? 0 : (size_t)((event->time - start) * count / span);
+
+        for (; sample < position && sample < count; sample++)
+        {
+            samples[sample] = this->NextSample();
+        }
+
+        //  A started tone begins at the start of its period.
+        if (event->on && !this->on)
+        {
+            this->phase = 0;
+        }
+
+        this->on = event->on;
+        this->events.Pop();
+    }
+
+    for (; sample < count; sample++)
+    {
+        samples[sample] = this->NextSample();
+    }
+}
+
+/***
+ *  NextSample:
+ *      Steps the square wave, silence while the tone is off.
+ *
+ *  @return The next sample.
+ ***/
+int16_t Beeper::NextSample()
+{
+    constexpr uint32_t period = BeeperConstants::SAMPLE_RATE / BeeperConstants::TONE_FREQUENCY;
+
+    if (!this->on)
+    {
+        return 0;
+    }
+
+    int16_t sample = (this->phase < period / 2) ? BeeperConstants::AMPLITUDE : -BeeperConstants::AMPLITUDE;
+    this->phase = (this->phase + 1) % period;
+
+    return sample;
+}
@@ -0,0 +1,56 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "SPSCQueue.h"
+#include <cstdint>
+
+namespace BeeperConstants
+{
+    constexpr uint32_t SAMPLE_RATE = 48000;
+    constexpr uint32_t TONE_FREQUENCY = 440;
+    constexpr int16_t AMPLITUDE = 4000;
+
+    //  The samples in an audio buffer unless configured otherwise, about 5 ms at the sample rate.
+    constexpr uint16_t DEFAULT_BUFFER_SAMPLES = 256;
+
+    //  The amount of tone changes held between the emulation and the audio thread.
+    constexpr size_t EVENT_CAPACITY = 256;
+};
+
+//  The sound timer starting or stopping the tone, and the host time it happened at.
+struct ToneEvent
+{
+    //  Nanoseconds of the host steady clock.
+    uint64_t time;
+    bool on;
+};
+
+//  The beeper tone, generated on the audio thread out of the tone changes the emulation thread reports.
+//  The changes pass through a lock-free queue, and land at the sample matching their time inside
+//  the buffer generated after them, so the tone keeps the timing of the sound timer.
+class Beeper
+{
+private:
+    SPSCQueue<ToneEvent, BeeperConstants::EVENT_CAPACITY> events;
+
+    //  Owned by the emulation thread: the last state queued.
+    bool reported{false};
+
+    //  Owned by the audio thread: the tone state, the position in the wave period,
+    //  and the host time the last buffer was generated at.
+    bool on{false};
+    uint32_t phase{};
+    uint64_t lastFill{};
+
+    //  Steps the square wave by a sample.
+    int16_t NextSample();
+
+public:
+    //  Called by the emulation thread with the sound state at the given time, queues only changes.
+    void SetTone(bool on, uint64_t time);
+
+    //  Called by the audio thread, generates the samples standing for the time since the last call.
+    void Fill(int16_t *samples, size_t count, uint64_t now);
+};
@@ -0,0 +1,145 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "DispatchBenchmark.h"
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+/**
+ *  MeasureDispatch:
+ *      This function runs a ROM with the given engine and measures how long it takes.
+ *      The time measured includes decoding, as every engine decodes lazily on its first visit.
+ *
+ * @param file_path The file path to the emulated code.
+ * @param engine    The engine executing the code.
+ * @param cycles    The amount of instructions to execute.
+ *
+ * @return          The seconds the run took.
+ */
+double MeasureDispatch(const char* file_path, Chip8Engine engine, uint64_t cycles)
+{
+    Chip8* chip = new Chip8(file_path, engine);
+
+    //  A fixed seed keeps the work the same between runs.
+    chip->Seed(0);
+
+    //  Idle loops are executed, so the dispatch is measured and not the fast-forward.
+    chip->SetSkipIdle(false);
+
+    auto start = std::chrono::steady_clock::now();
+    chip->Run(cycles);
+    auto end = std::chrono::steady_clock::now();
+
+    delete chip;
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+/**
+ *  WriteResults:
+ *      This function writes the results as CSV with a header line, for comparing releases.
+ *      Frames are 60 Hz timer frames of `DEFAULT_INSTRUCTIONS_PER_FRAME` instructions.
+ *
+ * @param file      The file to write.
+ * @param results   The results.
+ * @param count     The amount of results.
+ */
+void WriteResults(FILE* file, const BenchmarkResult* results, size_t count)
+{
+    fprintf(file, "rom,engine,cycles,seconds,instructions_per_second,frames_per_second,ns_per_cycle\n");
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const BenchmarkResult& result = results[i];
+        double instructionsPerSecond = result.cycles / result.seconds;
+
+        fprintf(file, "%s,%s,%llu,%.6f,%.0f,%.0f,%.3f\n",
+                result.file_path,
+                result.engine,
+                (unsigned long long)result.cycles,
+                result.seconds,
+                instructionsPerSecond,
+                instructionsPerSecond / Chip8Constants::DEFAULT_INSTRUCTIONS_PER_FRAME,
+                result.seconds * 1e9 / result.cycles);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t engineCount = sizeof(BENCHMARK_ENGINES) / sizeof(BENCHMARK_ENGINES[0]);
+    const char* csvPath = nullptr;
+    uint64_t cycles = BENCHMARK_CYCLES;
+    std::vector<BenchmarkResult> results;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--csv") && i + 1 < argc)
+        {
+            csvPath = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--cycles") && i + 1 < argc)
+        {
+            cycles = std::stoull(argv[++i]);
+        }
+        else
+        {
+            printf("Usage: %s [--cycles <Cycles>] [--csv <File or - for stdout>]\n", argv[0]);
+            abort();
+        }
+    }
+
+    printf("%-34s%-10s%14s%14s%14s\n", "ROM", "Engine", "M instr/s", "K frames/s", "ns/Cycle");
+
+    for (const char* file_path : BENCHMARK_FILES)
+    {
+        for (size_t engine = 0; engine < engineCount; engine++)
+        {
+            //  Without recompiled code the AOT engine would only measure the interpreter again.
+            if (BENCHMARK_ENGINES[engine] == Chip8Engine::AOT && Chip8AOT::ProgramCount() == 0)
+            {
+                continue;
+            }
+
+            BenchmarkResult result = {file_path, BENCHMARK_ENGINE_NAMES[engine], cycles, 0};
+
+            for (size_t repetition = 0; repetition < BENCHMARK_REPETITIONS; repetition++)
+            {
+                double seconds = MeasureDispatch(file_path, BENCHMARK_ENGINES[engine], cycles);
+
+                if (repetition == 0 || seconds < result.seconds)
+                {
+                    result.seconds = seconds;
+                }
+            }
+
+            double instructionsPerSecond = cycles / result.seconds;
+
+            printf("%-34s%-10s%14.1f%14.1f%14.3f\n",
+                   file_path,
+                   result.engine,
+                   instructionsPerSecond / 1e6,
+                   instructionsPerSecond / Chip8Constants::DEFAULT_INSTRUCTIONS_PER_FRAME / 1e3,
+                   result.seconds * 1e9 / cycles);
+
+            results.push_back(result);
+        }
+    }
+
+    if (csvPath != nullptr)
+    {
+        FILE* file = strcmp(csvPath, "-") ? fopen(csvPath, "w") : stdout;
+
+        if (file == nullptr)
+        {
+            throw std::runtime_error("Could not open the CSV file.");
+        }
+
+        WriteResults(file, results.data(), results.size());
+
+        if (file != stdout)
+        {
+            fclose(file);
+        }
+    }
+}
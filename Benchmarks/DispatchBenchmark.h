@@ -0,0 +1,36 @@
+#include <Chip8.h>
+#include <Chip8AOT.h>
+#include <stdexcept>
+
+//  The synthetic ROMs, each stressing one kind of work, and the opcode test ROM as a mix of everything.
+const char* BENCHMARK_FILES[] = {
+    "Benchmarks/ROMs/AluLoop.ch8",
+    "Benchmarks/ROMs/SpriteStorm.ch8",
+    "Benchmarks/ROMs/CallReturn.ch8",
+    "Benchmarks/ROMs/BranchLoop.ch8",
+    "UnitTests/test_opcode.ch8",
+};
+
+//  The engines compared, and how they are named in the report.
+//  The AOT engine is only measured when recompiled ROMs are linked in, as `make bench-aot` does.
+const Chip8Engine BENCHMARK_ENGINES[] = {Chip8Engine::Interpreter, Chip8Engine::Threaded, Chip8Engine::JIT, Chip8Engine::AOT};
+const char* BENCHMARK_ENGINE_NAMES[] = {"Table", "Threaded", "JIT", "AOT"};
+
+//  The amount of instructions each engine executes on each ROM, and how many times, keeping the fastest run.
+const uint64_t BENCHMARK_CYCLES = 20000000;
+const size_t BENCHMARK_REPETITIONS = 3;
+
+//  The outcome of running a ROM on an engine.
+struct BenchmarkResult
+{
+    const char* file_path;
+    const char* engine;
+    uint64_t cycles;
+    double seconds;
+};
+
+//  This function measures how long an engine takes to run a ROM
+double MeasureDispatch(const char* file_path, Chip8Engine engine, uint64_t cycles);
+
+//  This function writes the results as CSV, one line per ROM and engine
+void WriteResults(FILE* file, const BenchmarkResult* results, size_t count);
@@ -0,0 +1,97 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "UpscaleBenchmark.h"
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+/**
+ *  MeasureUpscale:
+ *      This function renders every screen into a window sized buffer, and measures how long it takes.
+ *
+ * @param pipeline      The filter and the persistence.
+ * @param scale         The window scale.
+ * @param vectorized    Whether the SIMD kernels run.
+ * @param screens       The screens, one after the other.
+ *
+ * @return              The seconds the rendering took.
+ */
+double MeasureUpscale(const UpscalePipeline& pipeline, uint32_t scale, bool vectorized, const std::vector<uint64_t>& screens)
+{
+    Upscaler upscaler(scale, pipeline.filter, pipeline.persistence, vectorized);
+    std::vector<uint32_t> pixels(upscaler.OutputWidth() * upscaler.OutputHeight());
+    size_t screenCount = screens.size() / Chip8Constants::VIDEO_HEIGHT;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t frame = 0; frame < UPSCALE_FRAMES; frame++)
+    {
+        upscaler.Render(screens.data() + (frame % screenCount) * Chip8Constants::VIDEO_HEIGHT,
+                        pixels.data(),
+                        upscaler.OutputWidth() * sizeof(uint32_t));
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    //  Reading a pixel back, so the rendering is not optimized away.
+    if (pixels[pixels.size() / 2] == 0x12345678u)
+    {
+        printf(" ");
+    }
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<uint64_t> screens;
+    Chip8 chip(UPSCALE_FILE);
+
+    if (argc > 1)
+    {
+        printf("Usage: %s\n", argv[0]);
+        abort();
+    }
+
+    //  Every frame of the program drawing its screen, so the blending sees pixels turning on and off.
+    for (size_t frame = 0; frame < 64; frame++)
+    {
+        chip.Run(Chip8Constants::DEFAULT_INSTRUCTIONS_PER_FRAME);
+        screens.insert(screens.end(), chip.video, chip.video + Chip8Constants::VIDEO_HEIGHT);
+    }
+
+    printf("%-20s%-8s%-10s%14s%14s%14s\n", "Pipeline", "Scale", "Kernels", "K frames/s", "M pixels/s", "us/Frame");
+
+    for (const UpscalePipeline& pipeline : UPSCALE_PIPELINES)
+    {
+        for (uint32_t scale : UPSCALE_SCALES)
+        {
+            for (bool vectorized : {false, true})
+            {
+                double seconds = 0;
+
+                for (size_t repetition = 0; repetition < UPSCALE_REPETITIONS; repetition++)
+                {
+                    double run = MeasureUpscale(pipeline, scale, vectorized, screens);
+
+                    if (repetition == 0 || run < seconds)
+                    {
+                        seconds = run;
+                    }
+                }
+
+                double framesPerSecond = UPSCALE_FRAMES / seconds;
+                double pixelsPerFrame = double(Chip8Constants::VIDEO_WIDTH * scale) * (Chip8Constants::VIDEO_HEIGHT * scale);
+
+                printf("%-20s%-8u%-10s%14.1f%14.1f%14.2f\n",
+                       pipeline.name,
+                       scale,
+                       vectorized ? "SIMD" : "Scalar",
+                       framesPerSecond / 1e3,
+                       framesPerSecond * pixelsPerFrame / 1e6,
+                       seconds * 1e6 / UPSCALE_FRAMES);
+            }
+        }
+    }
+}
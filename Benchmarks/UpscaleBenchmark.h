@@ -0,0 +1,30 @@
+#include <Upscaler.h>
+#include <stdexcept>
+
+//  The pipelines compared, and how they are named in the report.
+struct UpscalePipeline
+{
+    const char* name;
+    ScaleFilter filter;
+    uint8_t persistence;
+};
+
+const UpscalePipeline UPSCALE_PIPELINES[] = {
+    {"Nearest", ScaleFilter::Nearest, UpscalerConstants::NO_PERSISTENCE},
+    {"Scale2x", ScaleFilter::Scale2x, UpscalerConstants::NO_PERSISTENCE},
+    {"Nearest+Phosphor", ScaleFilter::Nearest, 192},
+    {"Scale2x+Phosphor", ScaleFilter::Scale2x, 192},
+};
+
+//  The window scales measured, 10 being the scale the Makefile runs the emulator at.
+const uint32_t UPSCALE_SCALES[] = {4, 10, 16};
+
+//  The amount of frames rendered per measurement, and how many times, keeping the fastest run.
+const size_t UPSCALE_FRAMES = 2000;
+const size_t UPSCALE_REPETITIONS = 3;
+
+//  The program drawing the screens, its screen after each frame is rendered.
+const char* UPSCALE_FILE = "UnitTests/test_opcode.ch8";
+
+//  This function measures how long a pipeline takes to render the given screens
+double MeasureUpscale(const UpscalePipeline& pipeline, uint32_t scale, bool vectorized, const std::vector<uint64_t>& screens);
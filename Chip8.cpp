@@ -2,90 +2,190 @@
 //  Created at: 17.02.21
 
 #include "Chip8.h"
+#include "Chip8AOT.h"
+#include "Chip8JIT.h"
+#include "ROMCache.h"
 #include <stdexcept>
+#include <algorithm>
 #include <chrono>
 #include <cstring>
+#include <vector>
 
 using namespace std;
 
+//  The profiling counters cost nothing unless `CHIP8_PROFILE` is defined.
+#ifdef CHIP8_PROFILE
+#define PROFILE_EXECUTE(instruction, address)                                           \
+    this->profile->operations[static_cast<uint8_t>((instruction)->operation)]++;        \
+    this->profile->pairs[static_cast<uint8_t>(this->profile->previous)]                 \
+                        [static_cast<uint8_t>((instruction)->operation)]++;             \
+    this->profile->previous = (instruction)->operation;                                 \
+    this->profile->addresses[(address) & Chip8Constants::ADDRESS_MASK]++;
+#define PROFILE_MEMORY(counts, address, length)                                         \
+    for (size_t profiled = 0; profiled < (length); profiled++)                          \
+    {                                                                                   \
+        this->profile->counts[((address) + profiled) & Chip8Constants::ADDRESS_MASK]++; \
+    }
+#else
+#define PROFILE_EXECUTE(instruction, address)
+#define PROFILE_MEMORY(counts, address, length)
+#endif
+
 /***
- *  Constructor:
- *      Setting all of the randomness seeds, setting the `Program Counter`to the
- *      starting address and set all of the fonts in the `Memory Buffer`.
+ *  Template:
+ *      Builds the state every machine starts from once, with the `Program Counter` at the
+ *      starting address and the fonts in the `Memory Buffer`.
  *
- *  @param file_path The file path of the Operations.
+ *  @return The shared initial state.
  ***/
-Chip8::Chip8(const char *file_path) : //  Initializing randomness seed.
-                                      randGen(std::chrono::system_clock::now().time_since_epoch().count()),
-                                      randByte(std::uniform_int_distribution<uint8_t>(0, 255U)),
-
-                                      //  Initializing `Program Counter` to the starting adresss.
-                                      pc(Chip8Constants::START_ADDRESS)
+const Chip8State &Chip8State::Template()
 {
+    static const Chip8State initial = []()
+    {
+        Chip8State state{};
 
-    //  Loading the program into the emulated ROM
-    this->LoadROM(file_path);
+        //  Initializing `Program Counter` to the starting adresss.
+        state.pc = Chip8Constants::START_ADDRESS;
+        state.instructionsPerFrame = Chip8Constants::DEFAULT_INSTRUCTIONS_PER_FRAME;
+        state.dirtyRows = UINT32_MAX;
 
-    //  Load fonts into memory.
-    for (size_t i = Chip8Constants::FONTSET_START_ADDRESS; i < (Chip8Constants::FONT_HEIGHT * Chip8Constants::AMOUNT_OF_CHARS); i++)
-    {
-        this->memory[i] = Chip8Constants::fontset[i - Chip8Constants::FONTSET_START_ADDRESS];
-    }
+        //  Load fonts into memory.
+        memcpy(&state.memory[Chip8Constants::FONTSET_START_ADDRESS], Chip8Constants::fontset, sizeof(Chip8Constants::fontset));
+
+        return state;
+    }();
+
+    return initial;
+}
+
+/***
+ *  BuildTables:
+ *      Sets up the function pointer tables, once for every `Chip8`.
+ *      Unassigned slots are left `nullptr`, and decoded as operations which do nothing.
+ *
+ *  @return The operation tables.
+ ***/
+constexpr Chip8::OperationTables Chip8::BuildTables()
+{
+    OperationTables tables{};
 
-    //  Set up function pointer table
     //  All the operations in which the first byte equals to 0, which there are 2 of.
-    this->table[0x0] = &Chip8::Table0;
-    this->table[0x1] = &Chip8::OP_1nnn;
-    this->table[0x2] = &Chip8::OP_2nnn;
-    this->table[0x3] = &Chip8::OP_3xkk;
-    this->table[0x4] = &Chip8::OP_4xkk;
-    this->table[0x5] = &Chip8::OP_5xy0;
-    this->table[0x6] = &Chip8::OP_6xkk;
-    this->table[0x7] = &Chip8::OP_7xkk;
+    tables.table[0x0] = &Chip8::Table0;
+    tables.table[0x1] = &Chip8::OP_1nnn;
+    tables.table[0x2] = &Chip8::OP_2nnn;
+    tables.table[0x3] = &Chip8::OP_3xkk;
+    tables.table[0x4] = &Chip8::OP_4xkk;
+    tables.table[0x5] = &Chip8::OP_5xy0;
+    tables.table[0x6] = &Chip8::OP_6xkk;
+    tables.table[0x7] = &Chip8::OP_7xkk;
 
     //  All the operations in which the first byte equals to 8, which there are 9 of..
-    this->table[0x8] = &Chip8::Table8;
-    this->table[0x9] = &Chip8::OP_9xy0;
-    this->table[0xA] = &Chip8::OP_Annn;
-    this->table[0xB] = &Chip8::OP_Bnnn;
-    this->table[0xC] = &Chip8::OP_Cxkk;
-    this->table[0xD] = &Chip8::OP_Dxyn;
+    tables.table[0x8] = &Chip8::Table8;
+    tables.table[0x9] = &Chip8::OP_9xy0;
+    tables.table[0xA] = &Chip8::OP_Annn;
+    tables.table[0xB] = &Chip8::OP_Bnnn;
+    tables.table[0xC] = &Chip8::OP_Cxkk;
+    tables.table[0xD] = &Chip8::OP_Dxyn;
 
     //  All the operations in which the first byte equals to E, which there are 2 of.
-    this->table[0xE] = &Chip8::TableE;
+    tables.table[0xE] = &Chip8::TableE;
 
     //  All the operations in which the first byte equals to F, which there are 9 of.
-    this->table[0xF] = &Chip8::TableF;
+    tables.table[0xF] = &Chip8::TableF;
 
     //  Operations starting with 0.
-    this->table0[0x0] = &Chip8::OP_00E0;
-    this->table0[0xE] = &Chip8::OP_00EE;
+    tables.table0[0x0] = &Chip8::OP_00E0;
+    tables.table0[0xE] = &Chip8::OP_00EE;
 
     //  Operations starting with 8.
-    this->table8[0x0] = &Chip8::OP_8xy0;
-    this->table8[0x1] = &Chip8::OP_8xy1;
-    this->table8[0x2] = &Chip8::OP_8xy2;
-    this->table8[0x3] = &Chip8::OP_8xy3;
-    this->table8[0x4] = &Chip8::OP_8xy4;
-    this->table8[0x5] = &Chip8::OP_8xy5;
-    this->table8[0x6] = &Chip8::OP_8xy6;
-    this->table8[0x7] = &Chip8::OP_8xy7;
-    this->table8[0xE] = &Chip8::OP_8xyE;
+    tables.table8[0x0] = &Chip8::OP_8xy0;
+    tables.table8[0x1] = &Chip8::OP_8xy1;
+    tables.table8[0x2] = &Chip8::OP_8xy2;
+    tables.table8[0x3] = &Chip8::OP_8xy3;
+    tables.table8[0x4] = &Chip8::OP_8xy4;
+    tables.table8[0x5] = &Chip8::OP_8xy5;
+    tables.table8[0x6] = &Chip8::OP_8xy6;
+    tables.table8[0x7] = &Chip8::OP_8xy7;
+    tables.table8[0xE] = &Chip8::OP_8xyE;
 
     //  Operations starting with E.
-    this->tableE[0x1] = &Chip8::OP_ExA1;
-    this->tableE[0xE] = &Chip8::OP_Ex9E;
+    tables.tableE[0x1] = &Chip8::OP_ExA1;
+    tables.tableE[0xE] = &Chip8::OP_Ex9E;
 
     //  OPerations starting with F.
-    this->tableF[0x07] = &Chip8::OP_Fx07;
-    this->tableF[0x0A] = &Chip8::OP_Fx0A;
-    this->tableF[0x15] = &Chip8::OP_Fx15;
-    this->tableF[0x18] = &Chip8::OP_Fx18;
-    this->tableF[0x1E] = &Chip8::OP_Fx1E;
-    this->tableF[0x29] = &Chip8::OP_Fx29;
-    this->tableF[0x33] = &Chip8::OP_Fx33;
-    this->tableF[0x55] = &Chip8::OP_Fx55;
-    this->tableF[0x65] = &Chip8::OP_Fx65;
+    tables.tableF[0x07] = &Chip8::OP_Fx07;
+    tables.tableF[0x0A] = &Chip8::OP_Fx0A;
+    tables.tableF[0x15] = &Chip8::OP_Fx15;
+    tables.tableF[0x18] = &Chip8::OP_Fx18;
+    tables.tableF[0x1E] = &Chip8::OP_Fx1E;
+    tables.tableF[0x29] = &Chip8::OP_Fx29;
+    tables.tableF[0x33] = &Chip8::OP_Fx33;
+    tables.tableF[0x55] = &Chip8::OP_Fx55;
+    tables.tableF[0x65] = &Chip8::OP_Fx65;
+
+    return tables;
+}
+
+const Chip8::OperationTables Chip8::tables = Chip8::BuildTables();
+
+/***
+ *  Constructor:
+ *      Copies the initial state out of the template, setting the randomness seed and loading the ROM.
+ *
+ *  @param file_path The file path of the Operations.
+ *  @param engine    The engine `Run` executes the instructions with.
+ ***/
+Chip8::Chip8(const char *file_path, Chip8Engine engine) : Chip8State(Chip8State::Template()),
+                                                          engine(engine)
+{
+    //  Initializing randomness seed, until `Seed` sets an explicit one.
+    this->randState = SeedState(std::chrono::system_clock::now().time_since_epoch().count());
+
+    //  Loading the program into the emulated ROM
+    this->LoadROM(file_path);
+
+    //  The translated code cache is only needed by the JIT engine, and the block lookup by the AOT engine.
+    if (this->engine == Chip8Engine::JIT)
+    {
+        this->jit.reset(new Chip8JIT(*this));
+    }
+    else if (this->engine == Chip8Engine::AOT)
+    {
+        this->aot.reset(new Chip8AOT(*this));
+    }
+}
+
+/***
+ *  Copy Constructor:
+ *      Copies the mutable machine state of another `Chip8`.
+ *      The decoded instructions are not copied, they are decoded again on their first visit.
+ *
+ *  @param other The `Chip8` to copy.
+ ***/
+Chip8::Chip8(const Chip8 &other) : Chip8State(other),
+                                   engine(other.engine),
+                                   skipIdle(other.skipIdle)
+{
+    //  Translated code points into the other machine, so the copy translates its own and checks its own blocks.
+    if (this->engine == Chip8Engine::JIT)
+    {
+        this->jit.reset(new Chip8JIT(*this));
+    }
+    else if (this->engine == Chip8Engine::AOT)
+    {
+        this->aot.reset(new Chip8AOT(*this));
+    }
+}
+
+/***
+ *  Fork:
+ *      Creates a copy of the machine, which continues from the same state independently.
+ *
+ *  @return The copy.
+ ***/
+std::unique_ptr<Chip8> Chip8::Fork() const
+{
+    return std::unique_ptr<Chip8>(new Chip8(*this));
 }
 
 Chip8::~Chip8()
@@ -101,63 +201,720 @@ Chip8::~Chip8()
  ***/
 void Chip8::LoadROM(const char *file_path)
 {
-    //  Opening the file as a binary stream and set the file pointer at the end.
-    std::ifstream code_file(file_path, std::ios::binary | std::ios::ate);
+    //  The file is read once per process, machines loading it again copy the cached image.
+    std::shared_ptr<const ROMImage> image = ROMCache::Instance().Load(file_path);
 
-    if (code_file.is_open())
+    if (image != nullptr)
     {
-        //  Get the current read position and assining it as the file size. Allocating a buffer to hold the contents of the file.
-        std::streampos file_size = code_file.tellg();
-        char *buffer = new char[file_size];
-
         //  Check if the memory size allocated for commands has enogh space for all the commands.
-        if (file_size > (Chip8Constants::RAM_SIZE_IN_BYTES - Chip8Constants::START_ADDRESS))
+        if (image->size > (Chip8Constants::RAM_SIZE_IN_BYTES - Chip8Constants::START_ADDRESS))
         {
             printf("Aborting, `ROM` file is bigger than allocated memory buffer.\n");
             throw std::overflow_error("ROM is bigger than allocated memory buffer.");
         }
 
-        //  Set the read position at the start of the file, fill the buffer and closing the file.
-        code_file.seekg(0, std::ios::beg);
-        code_file.read(buffer, file_size);
-        code_file.close();
+        //  Loading the image into the `Chip-8` memory, starting at 0x200.
+        memcpy(this->memory + Chip8Constants::START_ADDRESS, image->bytes, image->size);
+
+        //  The loaded code replaces anything decoded before.
+        this->InvalidateDecoded(Chip8Constants::START_ADDRESS, image->size);
+    }
+}
+
+void Chip8::Cycle()
+{
+    //  Looking up the decoded instruction at the Program Counter, decoding it only on the first visit.
+    const DecodedInstruction *instruction = &this->decodeCache.Peek(this->pc);
+
+    if (instruction->handler == nullptr)
+    {
+        instruction = this->DecodedAt(this->pc);
+    }
+
+    this->decoded = instruction;
+    PROFILE_EXECUTE(instruction, this->pc);
+
+    //  Increament of the Program counter.
+    this->pc += 2;
+
+    //  Execute the already resolved operation.
+    (this->*(instruction->handler))();
 
-        //  Loading the buffer contents into the `Chip-8` memory, starting at 0x200.
-        for (int unsigned i = 0; i < file_size; ++i)
+    //  Counting the instruction, the timers are derived from the count.
+    this->cycles++;
+}
+
+/***
+ *  TimerValue:
+ *      A timer ticks once at the end of every frame, which is every `instructionsPerFrame` instructions.
+ *      Its value is the value written less the frames which ended since, stopping at 0.
+ *
+ *  @param value    The value written to the timer.
+ *  @param setCycle The cycle the value was written at.
+ *
+ *  @return         The timer value at the current cycle.
+ ***/
+uint8_t Chip8::TimerValue(uint8_t value, uint64_t setCycle) const
+{
+    uint64_t ticks = this->cycles / this->instructionsPerFrame - setCycle / this->instructionsPerFrame;
+
+    return (ticks < value) ? value - ticks : 0;
+}
+
+uint8_t Chip8::DelayTimer() const
+{
+    return this->TimerValue(this->delayTimer, this->delayTimerCycle);
+}
+
+uint8_t Chip8::SoundTimer() const
+{
+    return this->TimerValue(this->soundTimer, this->soundTimerCycle);
+}
+
+/***
+ *  SeedState:
+ *      Scrambles the seed with a SplitMix64 step, so close seeds start far apart
+ *      and no seed gives the all zero state xorshift can not leave.
+ *
+ *  @param seed The seed.
+ *
+ *  @return     The randomness state.
+ ***/
+uint64_t Chip8::SeedState(uint64_t seed)
+{
+    uint64_t state = seed + 0x9E3779B97F4A7C15ull;
+
+    state = (state ^ (state >> 30)) * 0xBF58476D1CE4E5B9ull;
+    state = (state ^ (state >> 27)) * 0x94D049BB133111EBull;
+    state ^= state >> 31;
+
+    return (state != 0) ? state : 0x9E3779B97F4A7C15ull;
+}
+
+/***
+ *  NextRandomByte:
+ *      Steps a xorshift64* state, and returns the highest byte of the scrambled output.
+ *
+ *  @param state The randomness state.
+ *
+ *  @return      The random byte.
+ ***/
+uint8_t Chip8::NextRandomByte(uint64_t &state)
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+
+    return (state * 0x2545F4914F6CDD1Dull) >> 56;
+}
+
+void Chip8::Seed(uint64_t seed)
+{
+    this->randState = SeedState(seed);
+}
+
+/***
+ *  SetInstructionsPerFrame:
+ *      Sets the amount of instructions in a frame. The timers are rewritten with their current values,
+ *      so the frames which already ended keep counting with the old amount.
+ *
+ *  @param instructionsPerFrame The amount of instructions executed in each 60 Hz frame.
+ ***/
+void Chip8::SetInstructionsPerFrame(uint32_t instructionsPerFrame)
+{
+    if (instructionsPerFrame == 0)
+    {
+        throw std::invalid_argument("A frame must hold at least one instruction.");
+    }
+
+    this->delayTimer = this->DelayTimer();
+    this->soundTimer = this->SoundTimer();
+    this->delayTimerCycle = this->cycles;
+    this->soundTimerCycle = this->cycles;
+    this->instructionsPerFrame = instructionsPerFrame;
+}
+
+void Chip8::SetSkipIdle(bool skipIdle)
+{
+    this->skipIdle = skipIdle;
+
+    //  Jumps are decoded as idle jumps only while skipping, so everything is decoded again.
+    this->InvalidateDecoded(0, Chip8Constants::RAM_SIZE_IN_BYTES);
+}
+
+/***
+ *  Run:
+ *      Executes the given amount of cycles, either one `Cycle` at a time
+ *      or through the translated blocks of the JIT engine, or the recompiled blocks of the AOT engine.
+ *
+ *  @param cycles The amount of instructions to execute.
+ ***/
+void Chip8::Run(uint64_t cycles)
+{
+    //  Translated and recompiled blocks are not profiled, so profiling builds interpret them.
+#ifndef CHIP8_PROFILE
+    if (this->jit)
+    {
+        this->jit->Run(cycles);
+        return;
+    }
+
+    if (this->aot)
+    {
+        this->aot->Run(cycles);
+        return;
+    }
+#endif
+
+    if (this->engine == Chip8Engine::Threaded)
+    {
+        this->RunThreaded(cycles);
+        return;
+    }
+
+    for (uint64_t i = 0; i < cycles; i++)
+    {
+        this->Cycle();
+
+        //  Jumps and key waits close every idle loop, so only they look for one.
+        if (this->decoded->dispatch == Operation::OP_IdleJump || (this->decoded->operation == Operation::OP_Fx0A && this->skipIdle))
         {
-            memory[Chip8Constants::START_ADDRESS + i] = buffer[i];
+            i += this->SkipIdle(cycles - i - 1);
         }
+    }
+}
 
-        //  Free the buffer
-        delete[] buffer;
+/***
+ *  DecodedAt:
+ *      Looks up the decoded instruction at the given address, decoding it on its first visit.
+ *
+ *  @param address  The address of the instruction.
+ *
+ *  @return         The cache entry of the instruction.
+ ***/
+Chip8::DecodedInstruction *Chip8::DecodedAt(uint16_t address)
+{
+    DecodedInstruction *instruction = &this->decodeCache[address & Chip8Constants::ADDRESS_MASK];
+
+    if (instruction->handler == nullptr)
+    {
+        this->Decode(address, instruction);
     }
+
+    return instruction;
 }
 
-void Chip8::Cycle()
+/***
+ *  FindIdleLoop:
+ *      Matches the code at the given address against the loops which only wait for a key or for the delay timer.
+ *
+ *  @param address  The address the loop would start at.
+ *
+ *  @return         The kind of the loop, `None` if the code is not one.
+ ***/
+Chip8::IdleLoop Chip8::FindIdleLoop(uint16_t address)
+{
+    address &= Chip8Constants::ADDRESS_MASK;
+
+    const DecodedInstruction *first = this->DecodedAt(address);
+
+    if (first->operation == Operation::OP_Fx0A)
+    {
+        return IdleLoop::KeyWait;
+    }
+
+    if (first->operation == Operation::OP_1nnn)
+    {
+        return (first->nnn == address) ? IdleLoop::SelfJump : IdleLoop::None;
+    }
+
+    if (first->operation != Operation::OP_Fx07)
+    {
+        return IdleLoop::None;
+    }
+
+    const DecodedInstruction *test = this->DecodedAt(address + 2);
+    const DecodedInstruction *jump = this->DecodedAt(address + 4);
+
+    if (test->operation == Operation::OP_3xkk && test->x == first->x &&
+        jump->operation == Operation::OP_1nnn && jump->nnn == address)
+    {
+        return IdleLoop::DelayPoll;
+    }
+
+    return IdleLoop::None;
+}
+
+/***
+ *  SkipIdle:
+ *      Fast-forwards the idle loop at the Program Counter. Its iterations change nothing but the cycle count
+ *      and the polled register, until a key is pressed, which happens only between runs, or until the delay timer
+ *      reaches the polled value, which is computed out of the cycle count.
+ *      Profiling builds execute every iteration, so they are counted.
+ *
+ *  @param cycles   The most cycles which may be skipped.
+ *
+ *  @return         The amount of cycles skipped.
+ ***/
+uint64_t Chip8::SkipIdle(uint64_t cycles)
+{
+#ifdef CHIP8_PROFILE
+    return 0;
+#endif
+
+    switch (this->FindIdleLoop(this->pc))
+    {
+    case IdleLoop::KeyWait:
+        if (this->KeypadMask() != 0)
+        {
+            return 0;
+        }
+        break;
+
+    case IdleLoop::SelfJump:
+        break;
+
+    case IdleLoop::DelayPoll:
+    {
+        //  An iteration is `Fx07` reading the timer, `3xkk` not skipping and `1nnn` jumping back.
+        const DecodedInstruction *poll = this->DecodedAt(this->pc);
+        uint8_t awaited = this->DecodedAt(this->pc + 2)->kk;
+        uint8_t current = this->DelayTimer();
+        uint64_t iterations = cycles / 3;
+
+        if (current == awaited)
+        {
+            return 0;
+        }
+
+        //  The timer only counts down, the first `Fx07` reading it at the awaited value or below is found out of
+        //  the frame it reaches that value in. If that read is below the awaited value, the loop never ends.
+        if (current > awaited)
+        {
+            uint64_t frame = this->delayTimerCycle / this->instructionsPerFrame + (this->delayTimer - awaited);
+            uint64_t untilAwaited = (frame * this->instructionsPerFrame - this->cycles + 2) / 3;
+            uint64_t ticks = (this->cycles + 3 * untilAwaited) / this->instructionsPerFrame -
+                             this->delayTimerCycle / this->instructionsPerFrame;
+
+            if (awaited == 0 || ticks == uint64_t(this->delayTimer - awaited))
+            {
+                iterations = std::min(iterations, untilAwaited);
+            }
+        }
+
+        if (iterations == 0)
+        {
+            return 0;
+        }
+
+        //  The register holds the value read by the last skipped iteration.
+        this->cycles += 3 * (iterations - 1);
+        this->registers[poll->x] = this->DelayTimer();
+        this->cycles += 3;
+
+        return 3 * iterations;
+    }
+
+    default:
+        return 0;
+    }
+
+    //  Waiting for a key or jumping to itself lasts the whole run.
+    this->cycles += cycles;
+
+    return cycles;
+}
+
+/***
+ *  RunThreaded:
+ *      Executes the given amount of cycles in a single loop, without calling through the operation tables.
+ *      Each operation is jumped to directly out of its decoded index and ends with its own copy of the dispatch,
+ *      so the host branch predictor sees a separate indirect jump per operation.
+ *      Fused sequences run their operations one after the other under a single dispatch, and run only their
+ *      first operation when fewer cycles are left than they may execute.
+ *      Compilers without computed `goto` get the same loop built on a `switch`, without the fused sequences.
+ *
+ *  @param cycles The amount of instructions to execute.
+ ***/
+void Chip8::RunThreaded(uint64_t cycles)
+{
+    const DecodedInstruction *instruction;
+    const bool skipIdle = this->skipIdle;
+
+    //  Fetching the decoded instruction at the Program Counter, the same way `Cycle` does.
+#define THREADED_FETCH()                                                                \
+    instruction = &this->decodeCache.Peek(this->pc);                                    \
+    if (instruction->handler == nullptr)                                                \
+    {                                                                                   \
+        instruction = this->DecodedAt(this->pc);                                        \
+    }                                                                                   \
+    this->decoded = instruction;                                                        \
+    PROFILE_EXECUTE(instruction, this->pc);                                             \
+    this->pc += 2;
+
+    //  Counting every instruction, the timers are derived from the count.
+#define THREADED_TIMERS()                                                               \
+    this->cycles++;
+
+    //  Looking for an idle loop after an instruction which may close one, a key wait or an idle jump.
+#define THREADED_IDLE(operation)                                                        \
+    if (((operation) == Operation::OP_Fx0A && skipIdle) || (operation) == Operation::OP_IdleJump) \
+    {                                                                                   \
+        cycles -= this->SkipIdle(cycles - 1);                                           \
+    }
+
+#if defined(__GNUC__)
+#define THREADED_LABEL(name) &&LABEL_##name,
+    static void *const labels[] = {CHIP8_OPERATIONS(THREADED_LABEL) &&LABEL_IdleJump,
+                                   &&LABEL_Annn_Dxyn,
+                                   &&LABEL_6xkk_6xkk,
+                                   &&LABEL_3xkk_1nnn,
+                                   &&LABEL_4xkk_1nnn,
+                                   &&LABEL_Fx07_3xkk_1nnn};
+#undef THREADED_LABEL
+
+    static_assert(sizeof(labels) / sizeof(labels[0]) == static_cast<size_t>(Operation::OP_Fx07_3xkk_1nnn) + 1,
+                  "Every dispatched operation has a label.");
+
+    //  Ending an instruction, and jumping to the next one.
+#define THREADED_DISPATCH()                                                             \
+    if (--cycles == 0)                                                                  \
+    {                                                                                   \
+        return;                                                                         \
+    }                                                                                   \
+    THREADED_FETCH();                                                                   \
+    goto *labels[static_cast<uint8_t>(instruction->dispatch)];
+
+    //  Moving on to the next instruction of a fused sequence, which lies right after the current one.
+#define THREADED_FUSED_NEXT()                                                           \
+    --cycles;                                                                           \
+    instruction += 2;                                                                   \
+    if (instruction->handler == nullptr)                                                \
+    {                                                                                   \
+        instruction = this->DecodedAt(this->pc);                                        \
+    }                                                                                   \
+    this->decoded = instruction;                                                        \
+    this->pc += 2;
+
+#define THREADED_OPERATION(name)                                                        \
+    LABEL_##name:                                                                       \
+    this->OP_##name();                                                                  \
+    THREADED_TIMERS();                                                                  \
+    THREADED_IDLE(Operation::OP_##name);                                                \
+    THREADED_DISPATCH();
+
+    //  Two operations which always execute both.
+#define THREADED_FUSED_PAIR(first, second)                                              \
+    LABEL_##first##_##second:                                                           \
+    if (cycles < 2)                                                                     \
+    {                                                                                   \
+        goto LABEL_##first;                                                             \
+    }                                                                                   \
+    this->OP_##first();                                                                 \
+    THREADED_TIMERS();                                                                  \
+    THREADED_FUSED_NEXT();                                                              \
+    this->OP_##second();                                                                \
+    THREADED_TIMERS();                                                                  \
+    THREADED_DISPATCH();
+
+    //  A skip over a jump, the jump executes only when it is not skipped.
+#define THREADED_FUSED_BRANCH(skip)                                                     \
+    LABEL_##skip##_1nnn:                                                                \
+    if (cycles < 2)                                                                     \
+    {                                                                                   \
+        goto LABEL_##skip;                                                              \
+    }                                                                                   \
+    fallThrough = this->pc;                                                             \
+    this->OP_##skip();                                                                  \
+    THREADED_TIMERS();                                                                  \
+    if (this->pc == fallThrough)                                                        \
+    {                                                                                   \
+        THREADED_FUSED_NEXT();                                                          \
+        this->OP_1nnn();                                                                \
+        THREADED_TIMERS();                                                              \
+    }                                                                                   \
+    THREADED_DISPATCH();
+
+    //  The address following a skip, which the skip leaves the Program Counter at when it does not skip.
+    uint16_t fallThrough;
+
+    if (cycles == 0)
+    {
+        return;
+    }
+
+    THREADED_FETCH();
+    goto *labels[static_cast<uint8_t>(instruction->dispatch)];
+
+    CHIP8_OPERATIONS(THREADED_OPERATION)
+
+    //  An idle jump is a `1nnn`, only it has its own label.
+    LABEL_IdleJump:
+    this->OP_1nnn();
+    THREADED_TIMERS();
+    THREADED_IDLE(Operation::OP_IdleJump);
+    THREADED_DISPATCH();
+
+    THREADED_FUSED_PAIR(Annn, Dxyn)
+    THREADED_FUSED_PAIR(6xkk, 6xkk)
+    THREADED_FUSED_BRANCH(3xkk)
+    THREADED_FUSED_BRANCH(4xkk)
+
+    //  A delay timer poll, which may close an idle loop when it jumps.
+    LABEL_Fx07_3xkk_1nnn:
+    if (cycles < 3)
+    {
+        goto LABEL_Fx07;
+    }
+    this->OP_Fx07();
+    THREADED_TIMERS();
+    THREADED_FUSED_NEXT();
+    fallThrough = this->pc;
+    this->OP_3xkk();
+    THREADED_TIMERS();
+    if (this->pc == fallThrough)
+    {
+        THREADED_FUSED_NEXT();
+        this->OP_1nnn();
+        THREADED_TIMERS();
+        if (skipIdle)
+        {
+            cycles -= this->SkipIdle(cycles - 1);
+        }
+    }
+    THREADED_DISPATCH();
+
+#undef THREADED_FUSED_BRANCH
+#undef THREADED_FUSED_PAIR
+#undef THREADED_FUSED_NEXT
+#undef THREADED_DISPATCH
+#else
+#define THREADED_OPERATION(name)                                                        \
+    case Operation::OP_##name:                                                          \
+        this->OP_##name();                                                              \
+        THREADED_TIMERS();                                                              \
+        THREADED_IDLE(Operation::OP_##name);                                            \
+        break;
+
+    for (; cycles > 0; cycles--)
+    {
+        THREADED_FETCH();
+
+        switch (instruction->dispatch)
+        {
+            CHIP8_OPERATIONS(THREADED_OPERATION)
+
+        case Operation::OP_IdleJump:
+            this->OP_1nnn();
+            THREADED_TIMERS();
+            THREADED_IDLE(Operation::OP_IdleJump);
+            break;
+
+        //  The fused sequences execute their first operation only.
+        default:
+            (this->*(instruction->handler))();
+            THREADED_TIMERS();
+            break;
+        }
+    }
+#endif
+
+#undef THREADED_OPERATION
+#undef THREADED_IDLE
+#undef THREADED_TIMERS
+#undef THREADED_FETCH
+}
+
+/***
+ *  Decode:
+ *      Fetches the opcode at the given address and decodes it into its cache entry.
+ *
+ *  @param address      The address of the opcode in the `Memory Buffer`.
+ *  @param instruction  The cache entry to fill.
+ ***/
+void Chip8::Decode(uint16_t address, DecodedInstruction *instruction)
 {
     //  because the memory is a uint8 and the opcode is uint16,
     //  each opcode is 8 bit shift of the argument in PC, ORed with the memory in PC + 1.
-    this->opcode = (this->memory[pc] << 8u) | this->memory[pc + 1];
+    uint16_t opcode = (this->memory[address & Chip8Constants::ADDRESS_MASK] << 8u) |
+                      this->memory[(address + 1) & Chip8Constants::ADDRESS_MASK];
 
-    //  Increament of the Program counter.
-    this->pc += 2;
+    this->DecodeOpcode(opcode, instruction);
+    instruction->dispatch = this->DecodeDispatch(address & Chip8Constants::ADDRESS_MASK, instruction);
+}
 
-    //  Decode opcode and Execute.
-    (this->*table[(this->opcode & 0xF000u) >> 12u])();
+/***
+ *  DecodeDispatch:
+ *      Matches the code at the given address against the sequences the threaded dispatch runs under a single label.
+ *      Jumps to themselves, or back to a `Fx07` followed by a `3xkk` of the same register, may close an idle loop,
+ *      and only they look for the loop, which `SkipIdle` matches whole every time.
+ *      The fused sequences are the pairs most executed one after the other in the profiles of the test and game ROMs,
+ *      none of them writes memory, so the decoded code stays valid while they run.
+ *      Profiling builds dispatch every operation on its own, so all of them are counted.
+ *
+ *  @param address      The address of the decoded instruction.
+ *  @param instruction  The decoded instruction.
+ *
+ *  @return             The operation to dispatch.
+ ***/
+Chip8::Operation Chip8::DecodeDispatch([[maybe_unused]] uint16_t address, const DecodedInstruction *instruction) const
+{
+#ifdef CHIP8_PROFILE
+    return instruction->operation;
+#else
+    auto opcodeAt = [this](uint16_t at) -> uint16_t
+    {
+        return (this->memory[at & Chip8Constants::ADDRESS_MASK] << 8u) | this->memory[(at + 1) & Chip8Constants::ADDRESS_MASK];
+    };
+
+    auto idleJump = [this, &opcodeAt](uint16_t at, uint16_t target) -> bool
+    {
+        uint16_t poll = opcodeAt(target);
+        uint16_t test = opcodeAt(target + 2);
+
+        return this->skipIdle &&
+               (target == at || (((target + 4) & Chip8Constants::ADDRESS_MASK) == at &&
+                                 (poll & 0xF0FFu) == 0xF007u && (test & 0xFF00u) == (0x3000u | (poll & 0x0F00u))));
+    };
+
+    if (instruction->operation == Operation::OP_1nnn && idleJump(address, instruction->nnn))
+    {
+        return Operation::OP_IdleJump;
+    }
+
+    //  The instructions of a sequence are read out of consecutive cache entries, which do not wrap around the memory.
+    uint16_t next = opcodeAt(address + 2);
+    uint16_t last = opcodeAt(address + 4);
+    bool pair = (address + 4u <= Chip8Constants::RAM_SIZE_IN_BYTES);
+    bool triple = (address + 6u <= Chip8Constants::RAM_SIZE_IN_BYTES);
+
+    //  A skipped jump which closes an idle loop is left to be dispatched on its own, so it looks for the loop.
+    bool jump = ((next & 0xF000u) == 0x1000u && !idleJump(address + 2, next & 0x0FFFu));
+
+    switch (instruction->operation)
+    {
+    case Operation::OP_Annn:
+        return (pair && (next & 0xF000u) == 0xD000u) ? Operation::OP_Annn_Dxyn : instruction->operation;
 
-    //  Decreament of delay timer and sound timer if each were set.
-    this->delayTimer -= ((this->delayTimer > 0) ? 1 : 0);
-    this->soundTimer -= ((this->soundTimer > 0) ? 1 : 0);
+    case Operation::OP_6xkk:
+        return (pair && (next & 0xF000u) == 0x6000u) ? Operation::OP_6xkk_6xkk : instruction->operation;
+
+    case Operation::OP_3xkk:
+        return (pair && jump) ? Operation::OP_3xkk_1nnn : instruction->operation;
+
+    case Operation::OP_4xkk:
+        return (pair && jump) ? Operation::OP_4xkk_1nnn : instruction->operation;
+
+    case Operation::OP_Fx07:
+        return (triple && (next & 0xFF00u) == (0x3000u | (instruction->x << 8u)) && (last & 0xF000u) == 0x1000u)
+                   ? Operation::OP_Fx07_3xkk_1nnn
+                   : instruction->operation;
+
+    default:
+        return instruction->operation;
+    }
+#endif
 }
 
-//  Operation tables.
-void Chip8::Table0() { (this->*table0[this->opcode & 0x000Fu])(); }
+/***
+ *  DecodeOpcode:
+ *      Resolves the opcode through the operation tables down to the final operation
+ *      and extracts all of its operands once.
+ *
+ *  @param opcode       The opcode to decode.
+ *  @param instruction  The decoded instruction to fill.
+ ***/
+void Chip8::DecodeOpcode(uint16_t opcode, DecodedInstruction *instruction) const
+{
+    //  Resolving the second level tables here, so executing the instruction is a single call.
+    Chip8Func handler = tables.table[(opcode & 0xF000u) >> 12u];
 
-void Chip8::Table8() { (this->*table8[this->opcode & 0x000Fu])(); }
+    if (handler == &Chip8::Table0)
+    {
+        handler = ((opcode & 0x000Fu) <= 0xEu) ? tables.table0[opcode & 0x000Fu] : nullptr;
+    }
+    else if (handler == &Chip8::Table8)
+    {
+        handler = ((opcode & 0x000Fu) <= 0xEu) ? tables.table8[opcode & 0x000Fu] : nullptr;
+    }
+    else if (handler == &Chip8::TableE)
+    {
+        handler = ((opcode & 0x000Fu) <= 0xEu) ? tables.tableE[opcode & 0x000Fu] : nullptr;
+    }
+    else if (handler == &Chip8::TableF)
+    {
+        handler = ((opcode & 0x00FFu) <= 0x65u) ? tables.tableF[opcode & 0x00FFu] : nullptr;
+    }
+
+    //  Unassigned table slots are operations which do nothing.
+    instruction->handler = (handler != nullptr) ? handler : &Chip8::OP_NULL;
 
-void Chip8::TableE() { (this->*tableE[this->opcode & 0x000Fu])(); }
+    //  Finding the index of the operation for the threaded dispatch.
+#define OPERATION_HANDLER(name) &Chip8::OP_##name,
+    static const Chip8Func handlers[] = {CHIP8_OPERATIONS(OPERATION_HANDLER)};
+#undef OPERATION_HANDLER
+
+    instruction->operation = Operation::OP_NULL;
+
+    for (size_t i = 0; i < sizeof(handlers) / sizeof(handlers[0]); i++)
+    {
+        if (handlers[i] == instruction->handler)
+        {
+            instruction->operation = static_cast<Operation>(i);
+        }
+    }
 
-void Chip8::TableF() { (this->*tableF[this->opcode & 0x00FFu])(); }
+    instruction->dispatch = instruction->operation;
+    instruction->opcode = opcode;
+    instruction->nnn = (opcode & 0x0FFFu);
+    instruction->x = ((opcode & 0x0F00u) >> 8u);
+    instruction->y = ((opcode & 0x00F0u) >> 4u);
+    instruction->kk = (opcode & 0x00FFu);
+    instruction->n = (opcode & 0x000Fu);
+}
+
+/***
+ *  InvalidateDecoded:
+ *      Drops every decoded instruction which one of its bytes, or of the sequence fused with it, lies in the written range,
+ *      so they will be decoded again out of the new memory contents.
+ *
+ *  @param address  The first written address.
+ *  @param length   The amount of bytes written.
+ ***/
+void Chip8::InvalidateDecoded(uint16_t address, uint16_t length)
+{
+    //  The sequences starting up to the fused length before the range have their last bytes inside of it.
+    //  Only decoded entries are dropped, so writing data never commits the cache pages under it.
+    for (uint16_t i = 0; i < length + FUSED_BYTES; i++)
+    {
+        uint16_t at = address - (FUSED_BYTES - 1u) + i;
+
+        if (this->decodeCache.Peek(at).handler != nullptr)
+        {
+            this->decodeCache[at].handler = nullptr;
+        }
+    }
+
+    //  Blocks translated out of the written bytes are stale as well.
+    if (this->jit)
+    {
+        this->jit->Invalidate(address, length);
+    }
+
+    if (this->aot)
+    {
+        this->aot->Invalidate(address, length);
+    }
+}
+
+//  Operation tables, executing the already resolved operation.
+void Chip8::Table0() { (this->*(this->decoded->handler))(); }
+
+void Chip8::Table8() { (this->*(this->decoded->handler))(); }
+
+void Chip8::TableE() { (this->*(this->decoded->handler))(); }
+
+void Chip8::TableF() { (this->*(this->decoded->handler))(); }
 
 void Chip8::OP_NULL() {}
 
@@ -170,6 +927,9 @@ void Chip8::OP_NULL() {}
 void Chip8::OP_00E0()
 {
     memset(this->video, 0, sizeof(this->video));
+
+    //  Every row changed.
+    this->dirtyRows = UINT32_MAX;
 }
 
 /***
@@ -181,7 +941,7 @@ void Chip8::OP_00E0()
 void Chip8::OP_00EE()
 {
     --(this->sp);
-    this->pc = this->stack[this->sp];
+    this->pc = this->stack[this->sp & (Chip8Constants::STACK_LEVELS - 1)];
 }
 
 /***
@@ -193,7 +953,8 @@ void Chip8::OP_00EE()
 void Chip8::OP_2nnn()
 {
     //  Storing the current Program Counter in the stack, and moving the Stack Pointer up.
-    this->stack[this->sp] = this->pc;
+    //  The stack wraps around as in every other engine, so a runaway recursion stays inside of it.
+    this->stack[this->sp & (Chip8Constants::STACK_LEVELS - 1)] = this->pc;
     ++(this->sp);
 
     //  Calling the Jump command to jump to the needed address, ass it is done by the same calculation.
@@ -213,7 +974,7 @@ void Chip8::OP_2nnn()
 void Chip8::OP_1nnn()
 {
     //  Calculating the address to jump to.
-    uint16_t new_address = ((this->opcode) & 0x0FFFu);
+    uint16_t new_address = this->decoded->nnn;
 
     //  Jumping to the new address.
     this->pc = new_address;
@@ -228,7 +989,7 @@ void Chip8::OP_1nnn()
 void Chip8::OP_Bnnn()
 {
     //  Calculating the address to jump to.
-    uint16_t new_address = (this->registers[0x0u] + ((this->opcode) & 0x0FFFu));
+    uint16_t new_address = (this->registers[0x0u] + this->decoded->nnn);
 
     //  Jumping to the new address.
     this->pc = new_address;
@@ -245,9 +1006,9 @@ void Chip8::OP_Bnnn()
  ***/
 void Chip8::OP_3xkk()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t byte = (this->opcode & 0x00FFu);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t byte = this->decoded->kk;
 
     //  Moving the Program Pointer up with 2 to skip the next command.
     this->pc += ((this->registers[Vx] == byte) ? 2 : 0);
@@ -261,9 +1022,9 @@ void Chip8::OP_3xkk()
  ***/
 void Chip8::OP_5xy0()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t Vy = ((this->opcode & 0x00F0u) >> 4u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t Vy = this->decoded->y;
 
     //  Moving the Program Pointer up with 2 to skip the next command.
     this->pc += ((this->registers[Vx] == this->registers[Vy]) ? 2 : 0);
@@ -280,9 +1041,9 @@ void Chip8::OP_5xy0()
  ***/
 void Chip8::OP_4xkk()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t byte = (this->opcode & 0x00FFu);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t byte = this->decoded->kk;
 
     //  Moving the Program Pointer up with 2 to skip the next command.
     this->pc += ((this->registers[Vx] != byte) ? 2 : 0);
@@ -296,9 +1057,9 @@ void Chip8::OP_4xkk()
  ***/
 void Chip8::OP_9xy0()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t Vy = ((this->opcode & 0x00F0u) >> 4u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t Vy = this->decoded->y;
 
     //  Moving the Program Pointer up with 2 to skip the next command.
     this->pc += ((this->registers[Vx] != this->registers[Vy]) ? 2 : 0);
@@ -315,9 +1076,9 @@ void Chip8::OP_9xy0()
  ***/
 void Chip8::OP_6xkk()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t byte = (this->opcode & 0x00FFu);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t byte = this->decoded->kk;
 
     //  Appling the value of byte to Vx.
     this->registers[Vx] = byte;
@@ -331,9 +1092,9 @@ void Chip8::OP_6xkk()
  ***/
 void Chip8::OP_8xy0()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t Vy = ((this->opcode & 0x00F0u) >> 4u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t Vy = this->decoded->y;
 
     //  Setting the register Vx as the register Vy.
     this->registers[Vx] = this->registers[Vy];
@@ -347,8 +1108,8 @@ void Chip8::OP_8xy0()
  ***/
 void Chip8::OP_Annn()
 {
-    //  Calculating values out of the opcode.
-    uint16_t address = (this->opcode & 0x0FFFu);
+    //  Reading the operands out of the decoded opcode.
+    uint16_t address = this->decoded->nnn;
 
     //  Setting the index as the specified address.
     this->index = address;
@@ -362,10 +1123,10 @@ void Chip8::OP_Annn()
  ***/
 void Chip8::OP_Fx07()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
 
-    this->registers[Vx] = this->delayTimer;
+    this->registers[Vx] = this->DelayTimer();
 }
 
 /***
@@ -377,23 +1138,18 @@ void Chip8::OP_Fx07()
  ***/
 void Chip8::OP_Fx0A()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    bool keySaved = false;
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
 
-    //  Itterate over all the keys, and one more,
+    //  Saving the lowest pressed key,
     //  if no key is pressed the PC is reduced by size of a opcode.
-    for (size_t i = 0; i <= Chip8Constants::AMOUNT_OF_CHARS && !keySaved; i++)
+    if (this->keypad == 0)
     {
-        if (i == Chip8Constants::AMOUNT_OF_CHARS)
-        {
-            this->pc -= 2;
-        }
-        else if (this->keypad[i])
-        {
-            this->registers[Vx] = i;
-            keySaved = true;
-        }
+        this->pc -= 2;
+    }
+    else
+    {
+        this->registers[Vx] = __builtin_ctz(this->keypad);
     }
 }
 
@@ -405,10 +1161,11 @@ void Chip8::OP_Fx0A()
  ***/
 void Chip8::OP_Fx15()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
 
     this->delayTimer = this->registers[Vx];
+    this->delayTimerCycle = this->cycles;
 }
 
 /***
@@ -419,10 +1176,11 @@ void Chip8::OP_Fx15()
  ***/
 void Chip8::OP_Fx18()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
 
     this->soundTimer = this->registers[Vx];
+    this->soundTimerCycle = this->cycles;
 }
 
 /***
@@ -433,8 +1191,8 @@ void Chip8::OP_Fx18()
  ***/
 void Chip8::OP_Fx29()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
     uint8_t digit = this->registers[Vx];
 
     //  Each digit is 5 bytes long.
@@ -450,18 +1208,22 @@ void Chip8::OP_Fx29()
  ***/
 void Chip8::OP_Fx33()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
     uint8_t value = this->registers[Vx];
 
     //  Ones-Place
-    this->memory[this->index + 2] = value % 10;
+    this->memory[(this->index + 2) & Chip8Constants::ADDRESS_MASK] = value % 10;
 
     //  Tens-Place
-    this->memory[this->index + 1] = value % 100;
+    this->memory[(this->index + 1) & Chip8Constants::ADDRESS_MASK] = value % 100;
 
     //  Hundreds-Place
-    this->memory[this->index] = value % 1000;
+    this->memory[this->index & Chip8Constants::ADDRESS_MASK] = value % 1000;
+
+    //  The digits might have been written over code.
+    this->InvalidateDecoded(this->index, 3);
+    PROFILE_MEMORY(writes, this->index, 3);
 }
 
 /***
@@ -472,13 +1234,17 @@ void Chip8::OP_Fx33()
  ***/
 void Chip8::OP_Fx55()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
 
     for (size_t i = 0; i < Vx; i++)
     {
-        this->memory[this->index + i] = this->registers[i];
+        this->memory[(this->index + i) & Chip8Constants::ADDRESS_MASK] = this->registers[i];
     }
+
+    //  The registers might have been stored over code.
+    this->InvalidateDecoded(this->index, Vx);
+    PROFILE_MEMORY(writes, this->index, Vx);
 }
 
 /***
@@ -490,13 +1256,15 @@ void Chip8::OP_Fx55()
  ***/
 void Chip8::OP_Fx65()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
 
     for (size_t i = 0; i < Vx; i++)
     {
-        this->registers[i] = this->memory[this->index + i];
+        this->registers[i] = this->memory[(this->index + i) & Chip8Constants::ADDRESS_MASK];
     }
+
+    PROFILE_MEMORY(reads, this->index, Vx);
 }
 
 /****************************
@@ -510,9 +1278,9 @@ void Chip8::OP_Fx65()
  ***/
 void Chip8::OP_7xkk()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t byte = (this->opcode & 0x00FFu);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t byte = this->decoded->kk;
 
     //  Adding the value of byte to Vx.
     this->registers[Vx] += byte;
@@ -526,9 +1294,9 @@ void Chip8::OP_7xkk()
  ***/
 void Chip8::OP_8xy4()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t Vy = ((this->opcode & 0x00F0u) >> 4u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t Vy = this->decoded->y;
 
     //  Storing the sum in a bigger uint type to examine for a carry.
     uint16_t sum = this->registers[Vx] + this->registers[Vy];
@@ -548,8 +1316,8 @@ void Chip8::OP_8xy4()
  ***/
 void Chip8::OP_Fx1E()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
 
     //  Adding the value of byte to Vx.
     this->index += this->registers[Vx];
@@ -566,9 +1334,9 @@ void Chip8::OP_Fx1E()
  ***/
 void Chip8::OP_8xy5()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t Vy = ((this->opcode & 0x00F0u) >> 4u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t Vy = this->decoded->y;
 
     //  If there is no borrow, i.e. Vx is greater than Vy.
     this->registers[0xF] = (this->registers[Vx] > this->registers[Vy]);
@@ -585,9 +1353,9 @@ void Chip8::OP_8xy5()
  ***/
 void Chip8::OP_8xy7()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t Vy = ((this->opcode & 0x00F0u) >> 4u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t Vy = this->decoded->y;
 
     //  If there is no borrow, i.e. Vx is greater than Vy.
     this->registers[0xF] = (this->registers[Vy] > this->registers[Vx]);
@@ -607,9 +1375,9 @@ void Chip8::OP_8xy7()
  ***/
 void Chip8::OP_8xy1()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t Vy = ((this->opcode & 0x00F0u) >> 4u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t Vy = this->decoded->y;
 
     //  ORing the register Vx as the register Vy.
     this->registers[Vx] |= this->registers[Vy];
@@ -623,9 +1391,9 @@ void Chip8::OP_8xy1()
  ***/
 void Chip8::OP_8xy2()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t Vy = ((this->opcode & 0x00F0u) >> 4u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t Vy = this->decoded->y;
 
     //  ANDing the register Vx as the register Vy.
     this->registers[Vx] &= this->registers[Vy];
@@ -639,9 +1407,9 @@ void Chip8::OP_8xy2()
  ***/
 void Chip8::OP_8xy3()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t Vy = ((this->opcode & 0x00F0u) >> 4u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t Vy = this->decoded->y;
 
     //  XORing the register Vx as the register Vy.
     this->registers[Vx] ^= this->registers[Vy];
@@ -658,8 +1426,8 @@ void Chip8::OP_8xy3()
  ***/
 void Chip8::OP_8xy6()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
 
     //  Saves the LSB.
     this->registers[0xF] = (this->registers[Vx] & 0x1u);
@@ -676,8 +1444,8 @@ void Chip8::OP_8xy6()
  ***/
 void Chip8::OP_8xyE()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
 
     //  Saves the MSB, 0x80 is 1000 0000 in binary, which means it needs a shift of 7 bits to get the MSB.
     this->registers[0xF] = (this->registers[Vx] & 0x80u) >> 0x7u;
@@ -697,12 +1465,12 @@ void Chip8::OP_8xyE()
  ***/
 void Chip8::OP_Cxkk()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t byte = (this->opcode & 0x00FFu);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t byte = this->decoded->kk;
 
     //  Generating the random value and ANDing it with the byte value.
-    this->registers[Vx] = this->randByte(this->randGen) & byte;
+    this->registers[Vx] = NextRandomByte(this->randState) & byte;
 }
 
 /************************
@@ -718,40 +1486,207 @@ void Chip8::OP_Cxkk()
  ***/
 void Chip8::OP_Dxyn()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
-    uint8_t Vy = ((this->opcode & 0x00F0u) >> 4u);
-    uint8_t height = (this->opcode & 0x000Fu);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
+    uint8_t Vy = this->decoded->y;
+    uint8_t height = this->decoded->n;
 
     //  Wrap the position inside the video buffer if it going beyond screen boundaries.
     uint8_t xPos = this->registers[Vx] % Chip8Constants::VIDEO_WIDTH;
     uint8_t yPos = this->registers[Vy] % Chip8Constants::VIDEO_HEIGHT;
+    bool collision = false;
 
-    //  The VF indicates a collision of the sprite with it self.
-    this->registers[0xF] = 0;
+    //  The sprite is clipped at the bottom edge, rows past it are not drawn.
+    if (height > Chip8Constants::VIDEO_HEIGHT - yPos)
+    {
+        height = Chip8Constants::VIDEO_HEIGHT - yPos;
+    }
 
     for (size_t row = 0; row < height; row++)
     {
-        //  Loads the byte of the row in the memory starting from the index.
-        uint8_t spriteByte = this->memory[this->index + row];
+        //  Loads the byte of the row in the memory starting from the index,
+        //  and places it under the screen row, the bits shifted past the right edge are clipped.
+        uint8_t spriteByte = this->memory[(this->index + row) & Chip8Constants::ADDRESS_MASK];
+        uint64_t spriteRow = (uint64_t(spriteByte) << (Chip8Constants::VIDEO_WIDTH - Chip8Constants::BYTE_SIZE)) >> xPos;
+        uint64_t &screenRow = this->video[yPos + row];
+
+        //  A collision is a sprite pixel drawn over a pixel which is on.
+        collision |= (screenRow & spriteRow) != 0;
+
+        //  XORing the sprite row, and marking the row as changed.
+        screenRow ^= spriteRow;
+        this->dirtyRows |= (spriteRow != 0) ? (1u << (yPos + row)) : 0;
+    }
 
-        //  Itterating over the byte, bit by bit.
-        for (size_t column = 0; column < 8; column++)
+    //  The VF indicates a collision of the sprite with the screen.
+    this->registers[0xF] = collision ? 1 : 0;
+    PROFILE_MEMORY(reads, this->index, height);
+}
+
+#ifdef CHIP8_PROFILE
+/***
+ *  DumpProfile:
+ *      Writes the execution counts as JSON: the count of every executed operation, the most executed pairs
+ *      of operations, which pick the sequences to fuse, the most executed addresses with their opcodes,
+ *      and every memory byte read or written.
+ *
+ *  @param file_path The file to write.
+ ***/
+void Chip8::DumpProfile(const char *file_path) const
+{
+#define PROFILE_NAME(name) #name,
+    static const char *const names[] = {CHIP8_OPERATIONS(PROFILE_NAME)};
+#undef PROFILE_NAME
+
+    //  The amount of addresses and of pairs listed as hot.
+    constexpr size_t hotAddresses = 32;
+    constexpr size_t hotPairs = 16;
+
+    FILE *file = fopen(file_path, "w");
+
+    if (file == nullptr)
+    {
+        throw std::runtime_error("Could not open the profile file.");
+    }
+
+    fprintf(file, "{\n  \"cycles\": %llu,\n  \"operations\": {", (unsigned long long)this->cycles);
+
+    const char *separator = "";
+
+    for (size_t operation = 0; operation < OPERATION_COUNT; operation++)
+    {
+        if (this->profile->operations[operation])
         {
-            //  Getting the needed bit, and getting the pointer to the screen pixel.
-            uint8_t spritePixel = spriteByte & (0x80u >> column);
-            uint32_t *screenPixel = &(this->video[(yPos + row) * Chip8Constants::VIDEO_WIDTH + (xPos + column)]);
+            fprintf(file, "%s\n    \"%s\": %llu", separator, names[operation], (unsigned long long)this->profile->operations[operation]);
+            separator = ",";
+        }
+    }
 
-            if (spritePixel)
-            {
-                //  Raising the VF register in the case of collision.
-                this->registers[0xF] = (*screenPixel == 0xFFFFFFFF) ? 1 : 0;
+    //  Sorting the executed addresses by their count, the lower address first on ties.
+    std::vector<uint16_t> addresses;
 
-                //  XORing the sprite pixel.
-                *screenPixel ^= 0xFFFFFFFF;
-            }
+    for (size_t address = 0; address < Chip8Constants::RAM_SIZE_IN_BYTES; address++)
+    {
+        if (this->profile->addresses[address])
+        {
+            addresses.push_back(address);
+        }
+    }
+
+    std::stable_sort(addresses.begin(), addresses.end(), [this](uint16_t a, uint16_t b)
+                     { return this->profile->addresses[a] > this->profile->addresses[b]; });
+
+    //  Sorting the pairs the same way, a pair is indexed by its first operation and then its second.
+    std::vector<uint16_t> pairs;
+
+    for (size_t pair = 0; pair < OPERATION_COUNT * OPERATION_COUNT; pair++)
+    {
+        if (this->profile->pairs[pair / OPERATION_COUNT][pair % OPERATION_COUNT])
+        {
+            pairs.push_back(pair);
+        }
+    }
+
+    std::stable_sort(pairs.begin(), pairs.end(), [this](uint16_t a, uint16_t b)
+                     { return this->profile->pairs[a / OPERATION_COUNT][a % OPERATION_COUNT] >
+                              this->profile->pairs[b / OPERATION_COUNT][b % OPERATION_COUNT]; });
+
+    fprintf(file, "\n  },\n  \"hotPairs\": [");
+    separator = "";
+
+    for (size_t i = 0; i < pairs.size() && i < hotPairs; i++)
+    {
+        size_t first = pairs[i] / OPERATION_COUNT;
+        size_t second = pairs[i] % OPERATION_COUNT;
+
+        fprintf(file, "%s\n    {\"first\": \"%s\", \"second\": \"%s\", \"count\": %llu}",
+                separator, names[first], names[second], (unsigned long long)this->profile->pairs[first][second]);
+        separator = ",";
+    }
+
+    fprintf(file, "\n  ],\n  \"hotAddresses\": [");
+    separator = "";
+
+    for (size_t i = 0; i < addresses.size() && i < hotAddresses; i++)
+    {
+        uint16_t address = addresses[i];
+        uint16_t opcode = (this->memory[address] << 8u) | this->memory[(address + 1) & Chip8Constants::ADDRESS_MASK];
+
+        fprintf(file, "%s\n    {\"address\": %u, \"opcode\": \"%04X\", \"count\": %llu}",
+                separator, address, opcode, (unsigned long long)this->profile->addresses[address]);
+        separator = ",";
+    }
+
+    fprintf(file, "\n  ],\n  \"memory\": [");
+    separator = "";
+
+    for (size_t address = 0; address < Chip8Constants::RAM_SIZE_IN_BYTES; address++)
+    {
+        if (this->profile->reads[address] || this->profile->writes[address])
+        {
+            fprintf(file, "%s\n    {\"address\": %zu, \"reads\": %llu, \"writes\": %llu}",
+                    separator, address, (unsigned long long)this->profile->reads[address], (unsigned long long)this->profile->writes[address]);
+            separator = ",";
         }
     }
+
+    fprintf(file, "\n  ]\n}\n");
+    fclose(file);
+}
+#endif
+
+/***
+ *  ExpandVideo:
+ *      Expands rows of the bit packed video buffer into a pixel per 32 bits,
+ *      all bits set for a pixel which is on, for presenting the frame.
+ *
+ *  @param pixels   The buffer to write, starting at the first expanded row.
+ *  @param pitch    The number of bytes in a row of the pixels buffer.
+ *  @param firstRow The first row to expand.
+ *  @param rowCount The amount of rows to expand.
+ ***/
+void Chip8::ExpandVideo(uint32_t *pixels, size_t pitch, size_t firstRow, size_t rowCount) const
+{
+    ExpandRows(this->video, pixels, pitch, firstRow, rowCount);
+}
+
+/***
+ *  ExpandRows:
+ *      Expands rows of a bit packed screen into a pixel per 32 bits, the same way `ExpandVideo` does.
+ *
+ *  @param video    The bit packed screen, a 64 bit word per row.
+ *  @param pixels   The buffer to write, starting at the first expanded row.
+ *  @param pitch    The number of bytes in a row of the pixels buffer.
+ *  @param firstRow The first row to expand.
+ *  @param rowCount The amount of rows to expand.
+ ***/
+void Chip8::ExpandRows(const uint64_t *video, uint32_t *pixels, size_t pitch, size_t firstRow, size_t rowCount)
+{
+    for (size_t row = firstRow; row < firstRow + rowCount; row++)
+    {
+        uint64_t screenRow = video[row];
+        uint32_t *rowPixels = reinterpret_cast<uint32_t *>(reinterpret_cast<uint8_t *>(pixels) + (row - firstRow) * pitch);
+
+        for (size_t column = 0; column < Chip8Constants::VIDEO_WIDTH; column++)
+        {
+            //  The leftmost pixel is the highest bit, and a set bit turns into all bits set.
+            rowPixels[column] = -uint32_t((screenRow >> (Chip8Constants::VIDEO_WIDTH - 1 - column)) & 1u);
+        }
+    }
+}
+
+/***
+ *  TakeDirtyRows:
+ *      Returns the rows changed since the last call, and starts tracking again.
+ *
+ *  @return A bitmap of the changed rows, bit `i` stands for row `i`.
+ ***/
+uint32_t Chip8::TakeDirtyRows()
+{
+    uint32_t rows = this->dirtyRows;
+    this->dirtyRows = 0;
+
+    return rows;
 }
 
 /********************
@@ -765,12 +1700,12 @@ void Chip8::OP_Dxyn()
  ***/
 void Chip8::OP_Ex9E()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
     uint8_t key = this->registers[Vx];
 
-    //  Increasing Program Counter by 2, if the is pressed.
-    this->pc += (this->keypad[key]) ? 2 : 0;
+    //  Increasing Program Counter by 2, if the is pressed, keys past the keypad are never pressed.
+    this->pc += (key < Chip8Constants::AMOUNT_OF_CHARS && ((this->keypad >> key) & 1u)) ? 2 : 0;
 }
 
 /***
@@ -781,10 +1716,10 @@ void Chip8::OP_Ex9E()
  ***/
 void Chip8::OP_ExA1()
 {
-    //  Calculating values out of the opcode.
-    uint8_t Vx = ((this->opcode & 0x0F00u) >> 8u);
+    //  Reading the operands out of the decoded opcode.
+    uint8_t Vx = this->decoded->x;
     uint8_t key = this->registers[Vx];
 
-    //  Increasing Program Counter by 2, if the is not pressed.
-    this->pc += (!this->keypad[key]) ? 2 : 0;
+    //  Increasing Program Counter by 2, if the is not pressed, keys past the keypad are never pressed.
+    this->pc += !(key < Chip8Constants::AMOUNT_OF_CHARS && ((this->keypad >> key) & 1u)) ? 2 : 0;
 }
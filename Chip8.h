@@ -1,9 +1,14 @@
 //  Author:     The Mister M.A.
 //  Created at: 17.02.21
 
+#pragma once
+
+#include "ZeroedTable.h"
 #include <stdlib.h>
 #include <fstream>
-#include <random>
+#include <memory>
+#include <cstdint>
+#include <type_traits>
 
 namespace Chip8Constants
 {
@@ -18,11 +23,17 @@ namespace Chip8Constants
     //  The starting address, which the `Program Counter` would be initialize to
     constexpr uint16_t START_ADDRESS = 0x200;
 
+    //  Mask keeping an address inside the emulated memory.
+    constexpr uint16_t ADDRESS_MASK = RAM_SIZE_IN_BYTES - 1;
+
     //  Characters Font height and the number of each character.
     constexpr uint8_t AMOUNT_OF_CHARS = 16;
     constexpr uint8_t FONT_HEIGHT = 5;
     constexpr uint16_t FONTSET_START_ADDRESS = 0x50;
 
+    //  The timers tick at 60 Hz of emulated time, a frame being this many instructions unless configured otherwise.
+    constexpr uint32_t DEFAULT_INSTRUCTIONS_PER_FRAME = 10;
+
     constexpr uint8_t fontset[AMOUNT_OF_CHARS * FONT_HEIGHT] =
         {
             0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
@@ -44,44 +55,318 @@ namespace Chip8Constants
     };
 };
 
-class Chip8
+//  Every operation of the `Chip8`, used to generate the operation enumeration and the threaded dispatch.
+#define CHIP8_OPERATIONS(OPERATION) \
+    OPERATION(NULL)                 \
+    OPERATION(00E0)                 \
+    OPERATION(00EE)                 \
+    OPERATION(1nnn)                 \
+    OPERATION(2nnn)                 \
+    OPERATION(3xkk)                 \
+    OPERATION(4xkk)                 \
+    OPERATION(5xy0)                 \
+    OPERATION(6xkk)                 \
+    OPERATION(7xkk)                 \
+    OPERATION(8xy0)                 \
+    OPERATION(8xy1)                 \
+    OPERATION(8xy2)                 \
+    OPERATION(8xy3)                 \
+    OPERATION(8xy4)                 \
+    OPERATION(8xy5)                 \
+    OPERATION(8xy6)                 \
+    OPERATION(8xy7)                 \
+    OPERATION(8xyE)                 \
+    OPERATION(9xy0)                 \
+    OPERATION(Annn)                 \
+    OPERATION(Bnnn)                 \
+    OPERATION(Cxkk)                 \
+    OPERATION(Dxyn)                 \
+    OPERATION(Ex9E)                 \
+    OPERATION(ExA1)                 \
+    OPERATION(Fx07)                 \
+    OPERATION(Fx0A)                 \
+    OPERATION(Fx15)                 \
+    OPERATION(Fx18)                 \
+    OPERATION(Fx1E)                 \
+    OPERATION(Fx29)                 \
+    OPERATION(Fx33)                 \
+    OPERATION(Fx55)                 \
+    OPERATION(Fx65)
+
+//  The engines a `Chip8` can execute its instructions with.
+enum class Chip8Engine
 {
-private:
-    uint8_t registers[Chip8Constants::BASE_REG_AMOUNT]{};
-    uint8_t memory[Chip8Constants::RAM_SIZE_IN_BYTES]{};
-    uint16_t index{};
-    uint16_t pc{};
-    uint16_t stack[Chip8Constants::STACK_LEVELS]{};
-    uint8_t sp{};
-    uint8_t delayTimer{};
-    uint8_t soundTimer{};
-    uint16_t opcode;
-
-    //  Randomness seeds
-    std::default_random_engine randGen;
-    std::uniform_int_distribution<uint8_t> randByte;
+    //  Executes every instruction through the decoded operation handlers.
+    Interpreter,
+
+    //  Translates basic blocks into native x86-64 code, falling back to the interpreter elsewhere.
+    JIT,
+
+    //  Runs many instructions per call in a single direct-threaded loop, with the operations inlined into it.
+    Threaded,
+
+    //  Runs the basic blocks the ROM was recompiled into ahead of time, falling back to the interpreter elsewhere.
+    AOT
+};
+
+class Chip8AOT;
+class Chip8JIT;
+class Chip8Lockstep;
+
+//  The whole mutable state of a `Chip8`, plain data so a machine is created and copied with a single `memcpy`.
+struct Chip8State
+{
+    uint8_t registers[Chip8Constants::BASE_REG_AMOUNT];
+    uint8_t memory[Chip8Constants::RAM_SIZE_IN_BYTES];
+    uint16_t index;
+    uint16_t pc;
+    uint16_t stack[Chip8Constants::STACK_LEVELS];
+    uint8_t sp;
+
+    //  The timers hold the value last written and the cycle it was written at,
+    //  their current value is computed out of the frames which ended since.
+    uint8_t delayTimer;
+    uint8_t soundTimer;
+    uint64_t delayTimerCycle;
+    uint64_t soundTimerCycle;
+
+    //  The instructions executed so far, which are the emulated time the timers tick in.
+    uint64_t cycles;
+    uint32_t instructionsPerFrame;
+
+    //  A bit per screen row, raised when the row changes, so unchanged frames are not presented.
+    uint32_t dirtyRows;
+
+    //  The xorshift64* randomness state, part of the machine state so runs can be reproduced.
+    uint64_t randState;
+
+    //  The pressed keys, bit `i` stands for key `i`.
+    uint16_t keypad;
+
+    //  The screen as a 64 bit word per row, the leftmost pixel is the highest bit.
+    uint64_t video[Chip8Constants::VIDEO_HEIGHT];
+
+    //  The state of a machine before a ROM is loaded, with the fonts in memory.
+    static const Chip8State &Template();
+};
+
+static_assert(std::is_trivially_copyable<Chip8State>::value && std::is_standard_layout<Chip8State>::value,
+              "The machine state is copied as plain bytes.");
+static_assert(Chip8Constants::VIDEO_HEIGHT == 32, "A dirty bit per screen row fits a 32 bit word.");
+static_assert(Chip8Constants::VIDEO_WIDTH == 64, "A screen row is packed into a 64 bit word.");
 
+class Chip8 : private Chip8State
+{
+    friend class Chip8AOT;
+    friend class Chip8JIT;
+    friend class Chip8Lockstep;
+
+    //  The debugger inspects the state and the decoded instructions.
+    template <typename Hooks>
+    friend class Chip8Debugger;
+
+    //  The variants share the random number generator.
+    template <typename Policy>
+    friend class Chip8Variant;
+
+private:
     //  Typedefing the operation tables.
     typedef void (Chip8::*Chip8Func)();
-	Chip8Func table[0xF + 1]{&Chip8::OP_NULL};
-	Chip8Func table0[0xE + 1]{&Chip8::OP_NULL};
-	Chip8Func table8[0xE + 1]{&Chip8::OP_NULL};
-	Chip8Func tableE[0xE + 1]{&Chip8::OP_NULL};
-	Chip8Func tableF[0x65 + 1]{&Chip8::OP_NULL};
+
+    //  The operation tables, built at compile time and shared by every `Chip8`.
+    struct OperationTables
+    {
+        Chip8Func table[0xF + 1];
+        Chip8Func table0[0xE + 1];
+        Chip8Func table8[0xE + 1];
+        Chip8Func tableE[0xE + 1];
+        Chip8Func tableF[0x65 + 1];
+    };
+
+    static const OperationTables tables;
+    static constexpr OperationTables BuildTables();
+
+    //  The operations as indices, for the threaded dispatch.
+#define CHIP8_OPERATION_ENUM(name) OP_##name,
+    enum class Operation : uint8_t
+    {
+        CHIP8_OPERATIONS(CHIP8_OPERATION_ENUM)
+
+        //  Dispatched only: a `1nnn` which may close an idle loop, executed as `1nnn` and then looking for the loop.
+        OP_IdleJump,
+
+        //  Dispatched only: sequences the profiles show executed back to back, fused into a single dispatch.
+        OP_Annn_Dxyn,
+        OP_6xkk_6xkk,
+        OP_3xkk_1nnn,
+        OP_4xkk_1nnn,
+        OP_Fx07_3xkk_1nnn
+    };
+#undef CHIP8_OPERATION_ENUM
+
+#define CHIP8_OPERATION_COUNT(name) +1
+    static constexpr size_t OPERATION_COUNT = 0 CHIP8_OPERATIONS(CHIP8_OPERATION_COUNT);
+#undef CHIP8_OPERATION_COUNT
+
+    //  A pre-decoded instruction, holding the resolved handler, the operation it is dispatched as,
+    //  and the operands extracted out of the opcode.
+    struct DecodedInstruction
+    {
+        Chip8Func handler;
+        Operation operation;
+        Operation dispatch;
+        uint16_t opcode;
+        uint16_t nnn;
+        uint8_t x;
+        uint8_t y;
+        uint8_t kk;
+        uint8_t n;
+    };
+
+    //  The longest fused sequence in bytes, a fused entry depends on all of them.
+    static constexpr uint16_t FUSED_BYTES = 6;
+
+    //  Decoded instructions indexed by their address, a `nullptr` handler marks an entry which was not decoded yet.
+    //  Only the pages holding executed code are committed, so a machine and each of its forks stay small.
+    ZeroedTable<DecodedInstruction, Chip8Constants::RAM_SIZE_IN_BYTES> decodeCache;
+
+    //  The instruction currently being executed, which the operations read their operands from.
+    const DecodedInstruction *decoded{};
+
+    //  Decodes the opcode at the given address into its cache entry.
+    void Decode(uint16_t address, DecodedInstruction *instruction);
+    void DecodeOpcode(uint16_t opcode, DecodedInstruction *instruction) const;
+
+    //  Picks the operation the threaded dispatch jumps to, an idle jump or a fused sequence starting at the address.
+    Operation DecodeDispatch(uint16_t address, const DecodedInstruction *instruction) const;
+
+    //  Drops the decoded instructions overlapping the written memory range, so self-modifying code stays correct.
+    void InvalidateDecoded(uint16_t address, uint16_t length);
+
+    //  The loops which do nothing but wait for an event, which `SkipIdle` fast-forwards to.
+    enum class IdleLoop : uint8_t
+    {
+        None,
+
+        //  `Fx0A` waiting for a key.
+        KeyWait,
+
+        //  `1nnn` jumping to itself.
+        SelfJump,
+
+        //  `Fx07`, `3xkk` and `1nnn` back to the `Fx07`, polling the delay timer until it reaches `kk`.
+        DelayPoll
+    };
+
+    //  Returns the decoded instruction at the given address, decoding it on its first visit.
+    DecodedInstruction *DecodedAt(uint16_t address);
+
+    //  Recognizes the idle loop starting at the given address.
+    IdleLoop FindIdleLoop(uint16_t address);
+
+    //  Skips the iterations of the idle loop at the Program Counter which can not end it, within the given amount of cycles.
+    //  Returns the amount of cycles skipped, the machine state is the one executing them would reach.
+    uint64_t SkipIdle(uint64_t cycles);
+
+    //  Computes a timer value out of the value written and the cycle it was written at.
+    uint8_t TimerValue(uint8_t value, uint64_t setCycle) const;
+
+    //  Turns a seed into a randomness state, and steps a state returning the next random byte.
+    static uint64_t SeedState(uint64_t seed);
+    static uint8_t NextRandomByte(uint64_t &state);
+
+    //  Runs the given amount of cycles through the threaded dispatch loop.
+    void RunThreaded(uint64_t cycles);
+
+    //  The engine executing `Run`, and the translated code cache when it is the JIT,
+    //  or the recompiled blocks looked up when it is the AOT engine.
+    Chip8Engine engine;
+    std::unique_ptr<Chip8JIT> jit;
+    std::unique_ptr<Chip8AOT> aot;
+
+    //  Whether `Run` fast-forwards idle loops.
+    bool skipIdle{true};
+
+    //  Copies the machine state of another `Chip8`, used by `Fork`.
+    Chip8(const Chip8 &other);
+
+#ifdef CHIP8_PROFILE
+    //  Execution counts, only compiled in with `CHIP8_PROFILE`: per operation, per pair of operations executed
+    //  one after the other, per executed address, and memory reads and writes per byte by `Dxyn`, `Fx33`, `Fx55` and `Fx65`.
+    struct Profile
+    {
+        uint64_t operations[OPERATION_COUNT]{};
+        uint64_t pairs[OPERATION_COUNT][OPERATION_COUNT]{};
+        Operation previous{Operation::OP_NULL};
+        uint64_t addresses[Chip8Constants::RAM_SIZE_IN_BYTES]{};
+        uint64_t reads[Chip8Constants::RAM_SIZE_IN_BYTES]{};
+        uint64_t writes[Chip8Constants::RAM_SIZE_IN_BYTES]{};
+    };
+
+    std::unique_ptr<Profile> profile{new Profile()};
+#endif
 
 public:
-    uint8_t keypad[Chip8Constants::AMOUNT_OF_CHARS]{};
-    uint32_t video[Chip8Constants::VIDEO_WIDTH * Chip8Constants::VIDEO_HEIGHT]{};
+    using Chip8State::video;
 
-    Chip8(const char *file_path);
+    Chip8(const char *file_path, Chip8Engine engine = Chip8Engine::Interpreter);
     ~Chip8();
 
+    //  Creates a copy of the machine state, without reading the ROM again.
+    std::unique_ptr<Chip8> Fork() const;
+
     //  Loads the binary values in the file to the Memory attribute.
     void LoadROM(const char *file_path);
 
     //  Fetches, Decodes and Excutes code on cycles, the simulation cycle.
     void Cycle();
 
+    //  Executes the given amount of cycles with the engine chosen at construction.
+    void Run(uint64_t cycles);
+
+    //  The timers at the current cycle, and the amount of instructions executed so far.
+    uint8_t DelayTimer() const;
+    uint8_t SoundTimer() const;
+    uint64_t Cycles() const { return this->cycles; }
+
+    //  Reads the machine state, for tools scoring or inspecting it.
+    uint8_t Register(uint8_t x) const { return this->registers[x & (Chip8Constants::BASE_REG_AMOUNT - 1)]; }
+    uint8_t ReadMemory(uint16_t address) const { return this->memory[address & Chip8Constants::ADDRESS_MASK]; }
+
+    //  Seeds the randomness, the same seed and inputs reproduce a run exactly.
+    void Seed(uint64_t seed);
+
+    //  The keypad as a bitmask, bit `i` stands for key `i`.
+    uint16_t KeypadMask() const { return this->keypad; }
+    void SetKeypadMask(uint16_t keys) { this->keypad = keys; }
+
+    //  Sets the amount of instructions executed in each 60 Hz frame.
+    void SetInstructionsPerFrame(uint32_t instructionsPerFrame);
+
+    //  Enables or disables fast-forwarding idle loops in `Run`, which is enabled by default.
+    void SetSkipIdle(bool skipIdle);
+
+#ifdef CHIP8_PROFILE
+    //  Writes the execution counts gathered so far as JSON.
+    void DumpProfile(const char *file_path) const;
+#endif
+
+    //  Expands rows of the bit packed video buffer into 32 bit pixels, for presenting the frame.
+    void ExpandVideo(uint32_t *pixels,
+                     size_t pitch = Chip8Constants::VIDEO_WIDTH * sizeof(uint32_t),
+                     size_t firstRow = 0,
+                     size_t rowCount = Chip8Constants::VIDEO_HEIGHT) const;
+
+    //  Expands rows of a bit packed screen the same way, for screens copied out of a machine.
+    static void ExpandRows(const uint64_t *video,
+                           uint32_t *pixels,
+                           size_t pitch,
+                           size_t firstRow,
+                           size_t rowCount);
+
+    //  Returns the bitmap of rows changed by `00E0` and `Dxyn` since the last call, and clears it.
+    uint32_t TakeDirtyRows();
+
     //  Operation tables.
     void Table0();
     void Table8();
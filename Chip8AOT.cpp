@@ -0,0 +1,154 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "Chip8AOT.h"
+#include <algorithm>
+#include <cstring>
+
+/***
+ *  Constructor:
+ *      Every address is checked on its first visit, so the blocks match the memory at that time.
+ *
+ *  @param chip The emulator the recompiled blocks run on.
+ ***/
+Chip8AOT::Chip8AOT(Chip8 &chip) : chip(chip)
+{
+}
+
+/***
+ *  Programs:
+ *      The registry is created on its first use, as the generated code registers from static initializers.
+ *
+ *  @return Every program registered so far.
+ ***/
+std::vector<const Chip8AOTProgram *> &Chip8AOT::Programs()
+{
+    static std::vector<const Chip8AOTProgram *> programs;
+
+    return programs;
+}
+
+/***
+ *  Register:
+ *      Adds a recompiled program to the ones every `Chip8AOT` looks blocks up in.
+ *
+ *  @param program  The program, it must outlive every machine.
+ *
+ *  @return         Always `true`, so the generated code registers by initializing a static.
+ ***/
+bool Chip8AOT::Register(const Chip8AOTProgram &program)
+{
+    Programs().push_back(&program);
+
+    return true;
+}
+
+/***
+ *  Run:
+ *      Executes the given amount of cycles. Whole recompiled blocks are run natively,
+ *      addresses without a block and blocks longer than the cycles left run one `Cycle` at a time.
+ *
+ *  @param cycles The amount of instructions to execute.
+ ***/
+void Chip8AOT::Run(uint64_t cycles)
+{
+    Chip8State &state = this->chip;
+
+    while (cycles > 0)
+    {
+        uint16_t address = this->chip.pc & Chip8Constants::ADDRESS_MASK;
+        const Entry *entry = &this->entries.Peek(address);
+
+        if (!entry->checked)
+        {
+            Entry *checked = &this->entries[address];
+
+            this->Check(address, checked);
+            entry = checked;
+        }
+
+        //  An idle loop is skipped up to the event which can end it, before its block runs.
+        if (entry->idle && this->chip.skipIdle)
+        {
+            cycles -= this->chip.SkipIdle(cycles);
+
+            if (cycles == 0)
+            {
+                break;
+            }
+        }
+
+        if (entry->block == nullptr || entry->block->instructions > cycles)
+        {
+            this->chip.Cycle();
+            cycles--;
+            continue;
+        }
+
+        entry->block->code(state);
+        cycles -= entry->block->instructions;
+
+        //  No recompiled operation reads the cycle count, so the whole block is counted at once.
+        this->chip.cycles += entry->block->instructions;
+    }
+}
+
+/***
+ *  Check:
+ *      Looks the address up in every program, taking the first block whose ROM bytes are still in memory.
+ *      Comparing the bytes keeps blocks of other ROMs, and code the program rewrote, interpreted.
+ *
+ *  @param address  The address of the entry.
+ *  @param entry    The entry to fill.
+ ***/
+void Chip8AOT::Check(uint16_t address, Entry *entry)
+{
+    entry->block = nullptr;
+    entry->checked = true;
+    entry->idle = this->chip.FindIdleLoop(address) != Chip8::IdleLoop::None;
+
+    for (const Chip8AOTProgram *program : Programs())
+    {
+        const Chip8AOTBlock *end = program->blocks + program->blockCount;
+        const Chip8AOTBlock *block = std::lower_bound(program->blocks, end, address,
+                                                      [](const Chip8AOTBlock &block, uint16_t address)
+                                                      { return block.address < address; });
+
+        if (block == end || block->address != address)
+        {
+            continue;
+        }
+
+        //  The recompiler only emits blocks inside the ROM, so the bytes are there to compare.
+        size_t offset = address - Chip8Constants::START_ADDRESS;
+
+        if (memcmp(this->chip.memory + address, program->rom + offset, 2 * block->instructions) == 0)
+        {
+            entry->block = block;
+            return;
+        }
+    }
+}
+
+/***
+ *  Invalidate:
+ *      Drops every entry which its block, or the idle loop it starts, may overlap the written range.
+ *      A block covers at most `MAX_BLOCK_INSTRUCTIONS` opcodes, so only the entries starting
+ *      that far before the range have to be checked again.
+ *
+ *  @param address  The first written address.
+ *  @param length   The amount of bytes written.
+ ***/
+void Chip8AOT::Invalidate(uint16_t address, uint16_t length)
+{
+    int first = (address & Chip8Constants::ADDRESS_MASK) - (2 * Chip8AOTConstants::MAX_BLOCK_INSTRUCTIONS);
+    int last = (address & Chip8Constants::ADDRESS_MASK) + length;
+
+    for (int start = (first > 0) ? first : 0; start < last && start < Chip8Constants::RAM_SIZE_IN_BYTES; start++)
+    {
+        if (this->entries.Peek(start).checked)
+        {
+            this->entries[start].checked = false;
+        }
+    }
+}
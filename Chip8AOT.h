@@ -0,0 +1,75 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "Chip8.h"
+
+#include <vector>
+
+namespace Chip8AOTConstants
+{
+    //  The longest basic block recompiled, in instructions.
+    constexpr uint16_t MAX_BLOCK_INSTRUCTIONS = 64;
+};
+
+//  A recompiled basic block, runs all of its instructions on the machine state and sets the `Program Counter`.
+typedef void (*Chip8AOTBlockFunc)(Chip8State &state);
+
+struct Chip8AOTBlock
+{
+    uint16_t address;
+    uint16_t instructions;
+    Chip8AOTBlockFunc code;
+};
+
+//  A ROM recompiled into C++ by the recompiler, the generated code registers it before `main` runs.
+//  The blocks are sorted by their address, and each runs only while the memory still holds the ROM bytes it was compiled out of.
+struct Chip8AOTProgram
+{
+    const char *name;
+    const uint8_t *rom;
+    size_t romSize;
+    const Chip8AOTBlock *blocks;
+    size_t blockCount;
+};
+
+class Chip8AOT
+{
+private:
+    //  The block to run at an address, looked up again once the memory under it is written.
+    struct Entry
+    {
+        const Chip8AOTBlock *block;
+        bool checked;
+
+        //  The address may start an idle loop, which is skipped before it runs.
+        bool idle;
+    };
+
+    Chip8 &chip;
+
+    //  Entries indexed by the address, a `nullptr` block leaves the instruction to the interpreter.
+    ZeroedTable<Entry, Chip8Constants::RAM_SIZE_IN_BYTES> entries;
+
+    //  Finds a recompiled block starting at the address whose bytes match the memory.
+    void Check(uint16_t address, Entry *entry);
+
+    //  Every program linked in.
+    static std::vector<const Chip8AOTProgram *> &Programs();
+
+public:
+    Chip8AOT(Chip8 &chip);
+
+    //  Executes the given amount of cycles, a block runs only if it fits in the cycles left.
+    void Run(uint64_t cycles);
+
+    //  Drops the blocks overlapping the written memory range, their addresses are checked again on the next visit.
+    void Invalidate(uint16_t address, uint16_t length);
+
+    //  Adds a recompiled program, called by the generated code.
+    static bool Register(const Chip8AOTProgram &program);
+
+    //  The amount of programs linked in, without any the engine only interprets.
+    static size_t ProgramCount() { return Programs().size(); }
+};
@@ -0,0 +1,376 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "Chip8.h"
+#include <cstring>
+
+namespace Chip8DebuggerConstants
+{
+    //  The bitmaps hold a bit per address of the memory, 64 addresses per word.
+    constexpr size_t BITMAP_WORDS = Chip8Constants::RAM_SIZE_IN_BYTES / 64;
+};
+
+//  Why a run of the debugger returned.
+enum class Chip8StopReason
+{
+    //  Every cycle asked for was executed.
+    Finished,
+
+    //  The `Program Counter` reached a breakpoint, the instruction there was not executed yet.
+    Breakpoint,
+
+    //  The instruction at the `Program Counter` is about to read or write a watched address, it was not executed yet.
+    ReadWatchpoint,
+    WriteWatchpoint,
+
+    //  A register met its condition, the instruction changing it was executed.
+    RegisterCondition,
+
+    //  `Step`, `StepOver` or `RunTo` reached its target.
+    Stepped
+};
+
+struct Chip8Stop
+{
+    Chip8StopReason reason;
+
+    //  The `Program Counter`, the first watched address accessed, or the register which met its condition.
+    uint16_t address;
+};
+
+//  When a watched register stops the run.
+enum class RegisterCondition : uint8_t
+{
+    None,
+
+    //  The register is written a new value.
+    Changes,
+
+    //  The register changes to the given value.
+    Equals
+};
+
+//  The hooks of the production engine: there are none, so every check is compiled out
+//  and running costs exactly what `Chip8::Run` does.
+struct NoDebugHooks
+{
+    static constexpr bool ENABLED = false;
+};
+
+//  The hooks of the debug engine. Breakpoints and watchpoints are a bit per address,
+//  so checking an instruction costs the same however many of them are set.
+class DebugHooks
+{
+protected:
+    uint64_t breakpoints[Chip8DebuggerConstants::BITMAP_WORDS]{};
+    uint64_t readWatches[Chip8DebuggerConstants::BITMAP_WORDS]{};
+    uint64_t writeWatches[Chip8DebuggerConstants::BITMAP_WORDS]{};
+
+    //  The condition of each register, and a bit per register having one.
+    RegisterCondition conditions[Chip8Constants::BASE_REG_AMOUNT]{};
+    uint8_t conditionValues[Chip8Constants::BASE_REG_AMOUNT]{};
+    uint16_t watchedRegisters{};
+
+    static void SetBits(uint64_t *bitmap, uint16_t address, uint16_t length, bool enabled)
+    {
+        for (uint16_t i = 0; i < length; i++)
+        {
+            uint16_t bit = (address + i) & Chip8Constants::ADDRESS_MASK;
+            uint64_t mask = uint64_t(1) << (bit % 64);
+
+            bitmap[bit / 64] = enabled ? (bitmap[bit / 64] | mask) : (bitmap[bit / 64] & ~mask);
+        }
+    }
+
+    static bool TestBit(const uint64_t *bitmap, uint16_t address)
+    {
+        address &= Chip8Constants::ADDRESS_MASK;
+
+        return (bitmap[address / 64] >> (address % 64)) & 1u;
+    }
+
+    //  Returns the first watched address of the range, or -1 if none of it is watched.
+    static int FindWatched(const uint64_t *bitmap, uint16_t address, uint16_t length)
+    {
+        for (uint16_t i = 0; i < length; i++)
+        {
+            if (TestBit(bitmap, address + i))
+            {
+                return (address + i) & Chip8Constants::ADDRESS_MASK;
+            }
+        }
+
+        return -1;
+    }
+
+public:
+    static constexpr bool ENABLED = true;
+
+    void SetBreakpoint(uint16_t address, bool enabled = true) { SetBits(this->breakpoints, address, 1, enabled); }
+
+    //  Watches the bytes read by `Dxyn` and `Fx65`, or written by `Fx33` and `Fx55`.
+    void WatchReads(uint16_t address, uint16_t length = 1, bool enabled = true) { SetBits(this->readWatches, address, length, enabled); }
+    void WatchWrites(uint16_t address, uint16_t length = 1, bool enabled = true) { SetBits(this->writeWatches, address, length, enabled); }
+
+    //  Stops after an instruction changing the register meets the condition, `None` removes it.
+    void WatchRegister(uint8_t x, RegisterCondition condition, uint8_t value = 0)
+    {
+        x &= Chip8Constants::BASE_REG_AMOUNT - 1;
+
+        this->conditions[x] = condition;
+        this->conditionValues[x] = value;
+        this->watchedRegisters = (condition == RegisterCondition::None) ? (this->watchedRegisters & ~(1u << x)) : (this->watchedRegisters | (1u << x));
+    }
+};
+
+//  Runs a `Chip8` under a hooks policy, stopping at breakpoints, watchpoints and register conditions,
+//  and stepping over instructions, over calls, or up to an address.
+//  With `NoDebugHooks` a run is `Chip8::Run` with the engine of the machine, with `DebugHooks` the instructions
+//  are interpreted one at a time, idle loops included, and every one is checked before it executes.
+template <typename Hooks>
+class Chip8Debugger : public Hooks
+{
+private:
+    Chip8 &chip;
+
+    //  The last run stopped before executing the instruction at the `Program Counter`,
+    //  so the next run executes it without stopping at it again.
+    bool stoppedBefore{false};
+
+    //  Checks the instruction at the `Program Counter` against the breakpoints and watchpoints.
+    Chip8Stop CheckInstruction(uint16_t address);
+
+    //  Checks the registers written by the last instruction against their conditions.
+    Chip8Stop CheckRegisters(const uint8_t *previous) const;
+
+    //  Executes up to the given amount of cycles, stopping before an instruction at which `reached` is true.
+    template <typename Target>
+    Chip8Stop Execute(uint64_t cycles, Target reached);
+
+public:
+    Chip8Debugger(Chip8 &chip) : chip(chip) {}
+
+    //  Executes the given amount of cycles, unless a hook stops the run first.
+    Chip8Stop Run(uint64_t cycles);
+
+    //  Executes a single instruction.
+    Chip8Stop Step();
+
+    //  Executes a single instruction, a call being run until it returns, within the given amount of cycles.
+    Chip8Stop StepOver(uint64_t cycles);
+
+    //  Runs until the `Program Counter` reaches the address, within the given amount of cycles.
+    Chip8Stop RunTo(uint16_t address, uint64_t cycles);
+
+    //  The whole machine state, for inspecting it while stopped.
+    const Chip8State &State() const { return this->chip; }
+};
+
+//  The engine shipped, and the engine a debugger front end runs.
+typedef Chip8Debugger<NoDebugHooks> Chip8ProductionEngine;
+typedef Chip8Debugger<DebugHooks> Chip8DebugEngine;
+
+/***
+ *  Run:
+ *      Without hooks the cycles run through the engine of the machine, with them one instruction at a time.
+ *
+ *  @param cycles   The amount of instructions to execute.
+ *
+ *  @return         Where and why the run stopped.
+ ***/
+template <typename Hooks>
+Chip8Stop Chip8Debugger<Hooks>::Run(uint64_t cycles)
+{
+    if constexpr (!Hooks::ENABLED)
+    {
+        this->chip.Run(cycles);
+
+        return {Chip8StopReason::Finished, this->chip.pc};
+    }
+    else
+    {
+        return this->Execute(cycles, [](uint16_t)
+                             { return false; });
+    }
+}
+
+template <typename Hooks>
+Chip8Stop Chip8Debugger<Hooks>::Step()
+{
+    Chip8Stop stop = this->Execute(1, [](uint16_t)
+                                   { return false; });
+
+    return (stop.reason == Chip8StopReason::Finished) ? Chip8Stop{Chip8StopReason::Stepped, stop.address} : stop;
+}
+
+/***
+ *  StepOver:
+ *      Steps a single instruction, unless it is a call, which is run until it returns to the instruction after it
+ *      at the same stack depth, so recursive calls of the same subroutine are stepped over as well.
+ *
+ *  @param cycles   The most instructions to execute.
+ *
+ *  @return         Where and why the run stopped.
+ ***/
+template <typename Hooks>
+Chip8Stop Chip8Debugger<Hooks>::StepOver(uint64_t cycles)
+{
+    uint16_t address = this->chip.pc & Chip8Constants::ADDRESS_MASK;
+
+    if (this->chip.DecodedAt(address)->operation != Chip8::Operation::OP_2nnn)
+    {
+        return this->Step();
+    }
+
+    uint16_t returnAddress = (address + 2) & Chip8Constants::ADDRESS_MASK;
+    uint8_t sp = this->chip.sp;
+
+    return this->Execute(cycles, [this, returnAddress, sp](uint16_t pc)
+                         { return pc == returnAddress && this->chip.sp == sp; });
+}
+
+template <typename Hooks>
+Chip8Stop Chip8Debugger<Hooks>::RunTo(uint16_t address, uint64_t cycles)
+{
+    address &= Chip8Constants::ADDRESS_MASK;
+
+    return this->Execute(cycles, [address](uint16_t pc)
+                         { return pc == address; });
+}
+
+/***
+ *  Execute:
+ *      Interprets one instruction at a time. Before each one the target and the hooks are checked,
+ *      except for the first when the last run stopped before it, and after it the register conditions.
+ *
+ *  @param cycles   The most instructions to execute.
+ *  @param reached  Whether the target is reached at a `Program Counter`.
+ *
+ *  @return         Where and why the run stopped.
+ ***/
+template <typename Hooks>
+template <typename Target>
+Chip8Stop Chip8Debugger<Hooks>::Execute(uint64_t cycles, Target reached)
+{
+    bool resuming = this->stoppedBefore;
+
+    this->stoppedBefore = false;
+
+    for (uint64_t i = 0; i < cycles; i++)
+    {
+        uint16_t address = this->chip.pc & Chip8Constants::ADDRESS_MASK;
+        bool checked = (i > 0 || !resuming);
+
+        if (i > 0 && reached(address))
+        {
+            this->stoppedBefore = true;
+
+            return {Chip8StopReason::Stepped, address};
+        }
+
+        if constexpr (Hooks::ENABLED)
+        {
+            uint8_t previous[Chip8Constants::BASE_REG_AMOUNT];
+
+            if (checked)
+            {
+                Chip8Stop stop = this->CheckInstruction(address);
+
+                if (stop.reason != Chip8StopReason::Finished)
+                {
+                    this->stoppedBefore = true;
+
+                    return stop;
+                }
+            }
+
+            memcpy(previous, this->chip.registers, sizeof(previous));
+            this->chip.Cycle();
+
+            Chip8Stop stop = this->CheckRegisters(previous);
+
+            if (stop.reason != Chip8StopReason::Finished)
+            {
+                return stop;
+            }
+        }
+        else
+        {
+            this->chip.Cycle();
+        }
+    }
+
+    return {Chip8StopReason::Finished, this->chip.pc};
+}
+
+/***
+ *  CheckInstruction:
+ *      Looks the address up in the breakpoints, then the memory the instruction accesses up in the watchpoints.
+ *      The accessed bytes are known before executing: they start at the `Index Register`, `Dxyn` reading `n` of them,
+ *      `Fx65` reading and `Fx55` writing `x` of them, and `Fx33` writing 3.
+ *
+ *  @param address  The address of the instruction.
+ *
+ *  @return         The stop, `Finished` if the instruction may execute.
+ ***/
+template <typename Hooks>
+Chip8Stop Chip8Debugger<Hooks>::CheckInstruction(uint16_t address)
+{
+    if (Hooks::TestBit(this->breakpoints, address))
+    {
+        return {Chip8StopReason::Breakpoint, address};
+    }
+
+    const Chip8::DecodedInstruction *instruction = this->chip.DecodedAt(address);
+    const uint64_t *bitmap = nullptr;
+    uint16_t length = 0;
+    Chip8StopReason reason = Chip8StopReason::ReadWatchpoint;
+
+    switch (instruction->operation)
+    {
+    case Chip8::Operation::OP_Dxyn:
+        bitmap = this->readWatches;
+        length = instruction->n;
+        break;
+    case Chip8::Operation::OP_Fx65:
+        bitmap = this->readWatches;
+        length = instruction->x;
+        break;
+    case Chip8::Operation::OP_Fx55:
+        bitmap = this->writeWatches;
+        length = instruction->x;
+        reason = Chip8StopReason::WriteWatchpoint;
+        break;
+    case Chip8::Operation::OP_Fx33:
+        bitmap = this->writeWatches;
+        length = 3;
+        reason = Chip8StopReason::WriteWatchpoint;
+        break;
+    default:
+        break;
+    }
+
+    int watched = (bitmap != nullptr) ? Hooks::FindWatched(bitmap, this->chip.index, length) : -1;
+
+    return (watched < 0) ? Chip8Stop{Chip8StopReason::Finished, address} : Chip8Stop{reason, uint16_t(watched)};
+}
+
+template <typename Hooks>
+Chip8Stop Chip8Debugger<Hooks>::CheckRegisters(const uint8_t *previous) const
+{
+    for (uint16_t watched = this->watchedRegisters; watched != 0; watched &= watched - 1)
+    {
+        uint8_t x = __builtin_ctz(watched);
+        uint8_t value = this->chip.registers[x];
+
+        if (value != previous[x] &&
+            (this->conditions[x] == RegisterCondition::Changes || value == this->conditionValues[x]))
+        {
+            return {Chip8StopReason::RegisterCondition, x};
+        }
+    }
+
+    return {Chip8StopReason::Finished, this->chip.pc};
+}
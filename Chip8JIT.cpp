@@ -0,0 +1,515 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "Chip8JIT.h"
+#include <stdexcept>
+#include <cstring>
+
+#if CHIP8_JIT_SUPPORTED
+#include <sys/mman.h>
+#endif
+
+//  x86-64 encoding of the host registers used by the translated code.
+namespace HostRegisters
+{
+    constexpr uint8_t EAX = 0;
+    constexpr uint8_t ECX = 1;
+    constexpr uint8_t EDX = 2;
+
+    //  The `Chip8` pointer every block gets as its first argument.
+    constexpr uint8_t RDI = 7;
+};
+
+//  x86-64 condition codes of the SETcc instructions used by the translated code.
+namespace HostConditions
+{
+    constexpr uint8_t SETB = 0x92;
+    constexpr uint8_t SETE = 0x94;
+    constexpr uint8_t SETNE = 0x95;
+    constexpr uint8_t SETA = 0x97;
+};
+
+/***
+ *  Constructor:
+ *      Allocates the executable buffer and computes where the translated code finds
+ *      the `Chip8` state relative to the `Chip8` pointer it gets.
+ *
+ *  @param chip The emulator the blocks are translated for and run on.
+ ***/
+Chip8JIT::Chip8JIT(Chip8 &chip) : chip(chip)
+{
+    const uint8_t *base = reinterpret_cast<const uint8_t *>(&chip);
+
+    this->registersOffset = reinterpret_cast<const uint8_t *>(chip.registers) - base;
+    this->indexOffset = reinterpret_cast<const uint8_t *>(&chip.index) - base;
+    this->pcOffset = reinterpret_cast<const uint8_t *>(&chip.pc) - base;
+    this->stackOffset = reinterpret_cast<const uint8_t *>(chip.stack) - base;
+    this->spOffset = reinterpret_cast<const uint8_t *>(&chip.sp) - base;
+
+#if CHIP8_JIT_SUPPORTED
+    //  The buffer is only writable while a block is emitted, and only executable otherwise.
+    void *buffer = mmap(nullptr,
+                        Chip8JITConstants::CODE_BUFFER_SIZE,
+                        PROT_READ | PROT_EXEC,
+                        MAP_PRIVATE | MAP_ANONYMOUS,
+                        -1,
+                        0);
+
+    if (buffer == MAP_FAILED)
+    {
+        throw std::runtime_error("Could not allocate the JIT code buffer.");
+    }
+
+    this->codeBuffer = static_cast<uint8_t *>(buffer);
+#endif
+}
+
+Chip8JIT::~Chip8JIT()
+{
+#if CHIP8_JIT_SUPPORTED
+    munmap(this->codeBuffer, Chip8JITConstants::CODE_BUFFER_SIZE);
+#endif
+}
+
+/***
+ *  Run:
+ *      Executes the given amount of cycles. Whole translated blocks are run natively,
+ *      operations left to the interpreter and blocks longer than the cycles left run one `Cycle` at a time.
+ *
+ *  @param cycles The amount of instructions to execute.
+ ***/
+void Chip8JIT::Run(uint64_t cycles)
+{
+    while (cycles > 0)
+    {
+        uint16_t address = this->chip.pc & Chip8Constants::ADDRESS_MASK;
+        const Block *block = &this->blocks.Peek(address);
+
+        if (!block->translated)
+        {
+            Block *translated = &this->blocks[address];
+
+            this->Translate(address, translated);
+            block = translated;
+        }
+
+        //  An idle loop is skipped up to the event which can end it, before its block runs.
+        if (block->idle && this->chip.skipIdle)
+        {
+            cycles -= this->chip.SkipIdle(cycles);
+
+            if (cycles == 0)
+            {
+                break;
+            }
+        }
+
+        if (block->instructions == 0 || block->instructions > cycles)
+        {
+            this->chip.Cycle();
+            cycles--;
+            continue;
+        }
+
+        block->code(&this->chip);
+        cycles -= block->instructions;
+
+        //  No translated operation reads the cycle count, so the whole block is counted at once.
+        this->chip.cycles += block->instructions;
+    }
+}
+
+/***
+ *  Invalidate:
+ *      Drops every block which its instructions overlap the written range.
+ *      A block covers at most `MAX_BLOCK_INSTRUCTIONS` opcodes, so only the blocks starting
+ *      that far before the range have to be checked.
+ *
+ *  @param address  The first written address.
+ *  @param length   The amount of bytes written.
+ ***/
+void Chip8JIT::Invalidate(uint16_t address, uint16_t length)
+{
+    int first = (address & Chip8Constants::ADDRESS_MASK) - (2 * Chip8JITConstants::MAX_BLOCK_INSTRUCTIONS);
+    int last = (address & Chip8Constants::ADDRESS_MASK) + length;
+
+    for (int start = (first > 0) ? first : 0; start < last && start < Chip8Constants::RAM_SIZE_IN_BYTES; start++)
+    {
+        const Block *block = &this->blocks.Peek(start);
+
+        //  A block without instructions still caches the decision about its first opcode.
+        int end = start + 2 * ((block->instructions > 0) ? block->instructions : 1);
+
+        if (block->translated && end > (address & Chip8Constants::ADDRESS_MASK))
+        {
+            this->blocks[start].translated = false;
+        }
+    }
+}
+
+/***
+ *  Flush:
+ *      Drops every translated block, so the executable buffer can be filled from its start.
+ ***/
+void Chip8JIT::Flush()
+{
+    this->blocks.Clear();
+    this->codeUsed = 0;
+}
+
+/***
+ *  Translate:
+ *      Translates the instructions from the given address up to the first
+ *      jump, call, return or skip, or up to the first operation left to the interpreter.
+ *
+ *  @param address  The address of the first opcode of the block.
+ *  @param block    The block entry to fill.
+ ***/
+void Chip8JIT::Translate(uint16_t address, Block *block)
+{
+    block->translated = true;
+    block->instructions = 0;
+    block->code = nullptr;
+
+    //  The rest of the loop lies outside of the block, so `SkipIdle` matches it again on every visit.
+    block->idle = (this->chip.FindIdleLoop(address) != Chip8::IdleLoop::None);
+
+#if CHIP8_JIT_SUPPORTED
+    //  Making sure the longest block fits, before the entry is filled.
+    constexpr size_t maxBlockSize = (Chip8JITConstants::MAX_BLOCK_INSTRUCTIONS + 1) * Chip8JITConstants::MAX_INSTRUCTION_CODE_SIZE;
+
+    if (this->codeUsed + maxBlockSize > Chip8JITConstants::CODE_BUFFER_SIZE)
+    {
+        this->Flush();
+        block->translated = true;
+        block->idle = (this->chip.FindIdleLoop(address) != Chip8::IdleLoop::None);
+    }
+
+    mprotect(this->codeBuffer, Chip8JITConstants::CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE);
+
+    this->emitBuffer = this->codeBuffer + this->codeUsed;
+    this->emitUsed = 0;
+
+    uint16_t instructionAddress = address;
+    bool endsBlock = false;
+
+    while (!endsBlock && block->instructions < Chip8JITConstants::MAX_BLOCK_INSTRUCTIONS)
+    {
+        //  Sharing the interpreter's decoding, so both engines resolve every opcode the same way.
+        Chip8::DecodedInstruction *instruction = &this->chip.decodeCache[instructionAddress];
+
+        if (instruction->handler == nullptr)
+        {
+            this->chip.Decode(instructionAddress, instruction);
+        }
+
+        if (!this->TranslateInstruction(instruction, instructionAddress + 2, &endsBlock))
+        {
+            break;
+        }
+
+        block->instructions++;
+        instructionAddress += 2;
+
+        //  Blocks never wrap around the end of the memory.
+        if (instructionAddress + 1 > Chip8Constants::ADDRESS_MASK)
+        {
+            break;
+        }
+    }
+
+    //  Blocks which did not end with a jump continue at the next opcode.
+    if (!endsBlock)
+    {
+        this->EmitSetPC(instructionAddress);
+        this->Emit(0xC3);
+    }
+
+    if (block->instructions > 0)
+    {
+        block->code = reinterpret_cast<BlockFunc>(this->emitBuffer);
+        this->codeUsed += this->emitUsed;
+    }
+
+    mprotect(this->codeBuffer, Chip8JITConstants::CODE_BUFFER_SIZE, PROT_READ | PROT_EXEC);
+#endif
+}
+
+/***
+ *  TranslateInstruction:
+ *      Emits the native code of a single instruction, picked by the operation its opcode was resolved to.
+ *      The `Program Counter` is only written by the last instruction of the block,
+ *      as every address inside of the block is known while translating.
+ *
+ *  @param instruction  The decoded instruction.
+ *  @param nextAddress  The address of the opcode following the instruction.
+ *  @param endsBlock    Raised when the instruction sets the `Program Counter` and ends the block.
+ *
+ *  @return             False if the operation is left to the interpreter.
+ ***/
+bool Chip8JIT::TranslateInstruction(const Chip8::DecodedInstruction *instruction, uint16_t nextAddress, bool *endsBlock)
+{
+    using namespace HostRegisters;
+
+    typedef void (Chip8::*Chip8Func)();
+    Chip8Func handler = instruction->handler;
+
+    int32_t Vx = this->registersOffset + instruction->x;
+    int32_t VF = this->registersOffset + 0xF;
+
+    if (handler == &Chip8::OP_NULL)
+    {
+    }
+    //  LD Vx, byte:    mov byte [Vx], kk
+    else if (handler == &Chip8::OP_6xkk)
+    {
+        this->EmitModRM(0xC6, 0, Vx);
+        this->Emit(instruction->kk);
+    }
+    //  ADD Vx, byte:   add byte [Vx], kk
+    else if (handler == &Chip8::OP_7xkk)
+    {
+        this->EmitModRM(0x80, 0, Vx);
+        this->Emit(instruction->kk);
+    }
+    //  LD Vx, Vy:      movzx eax, [Vy]; mov [Vx], al
+    else if (handler == &Chip8::OP_8xy0)
+    {
+        this->EmitLoadRegister(EAX, instruction->y);
+        this->EmitModRM(0x88, EAX, Vx);
+    }
+    //  OR/AND/XOR Vx, Vy:  movzx eax, [Vy]; op [Vx], al
+    else if (handler == &Chip8::OP_8xy1 || handler == &Chip8::OP_8xy2 || handler == &Chip8::OP_8xy3)
+    {
+        this->EmitLoadRegister(EAX, instruction->y);
+        this->EmitModRM((handler == &Chip8::OP_8xy1) ? 0x08 : (handler == &Chip8::OP_8xy2) ? 0x20 : 0x30, EAX, Vx);
+    }
+    //  ADD Vx, Vy:     eax = Vx + Vy; VF = eax >> 8; Vx = al
+    else if (handler == &Chip8::OP_8xy4)
+    {
+        this->EmitLoadRegister(EAX, instruction->x);
+        this->EmitLoadRegister(ECX, instruction->y);
+        this->Emit(0x01); //  add eax, ecx
+        this->Emit(0xC8);
+        this->Emit(0x89); //  mov edx, eax
+        this->Emit(0xC2);
+        this->Emit(0xC1); //  shr edx, 8
+        this->Emit(0xEA);
+        this->Emit(0x08);
+        this->EmitModRM(0x88, EDX, VF);
+        this->EmitModRM(0x88, EAX, Vx);
+    }
+    //  SUB/SUBN Vx, Vy:    VF = (Vx > Vy) or (Vy > Vx); sub [Vx], [Vy]
+    else if (handler == &Chip8::OP_8xy5 || handler == &Chip8::OP_8xy7)
+    {
+        this->EmitLoadRegister(EAX, instruction->x);
+        this->EmitLoadRegister(ECX, instruction->y);
+        this->Emit(0x38); //  cmp al, cl
+        this->Emit(0xC8);
+        this->Emit(0x0F); //  seta dl / setb dl
+        this->Emit((handler == &Chip8::OP_8xy5) ? HostConditions::SETA : HostConditions::SETB);
+        this->Emit(0xC2);
+        this->EmitModRM(0x88, EDX, VF);
+
+        //  Vy is read again, as it is VF itself when Y equals F.
+        this->EmitLoadRegister(EAX, instruction->y);
+        this->EmitModRM(0x28, EAX, Vx);
+    }
+    //  SHR Vx:         VF = Vx & 1; shr byte [Vx], 1
+    else if (handler == &Chip8::OP_8xy6)
+    {
+        this->EmitLoadRegister(EAX, instruction->x);
+        this->Emit(0x83); //  and eax, 1
+        this->Emit(0xE0);
+        this->Emit(0x01);
+        this->EmitModRM(0x88, EAX, VF);
+        this->EmitModRM(0xD0, 5, Vx);
+    }
+    //  SHL Vx:         VF = Vx >> 7; shl byte [Vx], 1
+    else if (handler == &Chip8::OP_8xyE)
+    {
+        this->EmitLoadRegister(EAX, instruction->x);
+        this->Emit(0xC1); //  shr eax, 7
+        this->Emit(0xE8);
+        this->Emit(0x07);
+        this->EmitModRM(0x88, EAX, VF);
+        this->EmitModRM(0xD0, 4, Vx);
+    }
+    //  LD I, nnn:      mov word [index], nnn
+    else if (handler == &Chip8::OP_Annn)
+    {
+        this->Emit(0x66);
+        this->EmitModRM(0xC7, 0, this->indexOffset);
+        this->Emit16(instruction->nnn);
+    }
+    //  ADD I, Vx:      movzx eax, [Vx]; add word [index], ax
+    else if (handler == &Chip8::OP_Fx1E)
+    {
+        this->EmitLoadRegister(EAX, instruction->x);
+        this->Emit(0x66);
+        this->EmitModRM(0x01, EAX, this->indexOffset);
+    }
+    //  LD F, Vx:       movzx eax, [Vx]; lea eax, [rax + rax * 4 + FONTSET_START_ADDRESS]; mov word [index], ax
+    else if (handler == &Chip8::OP_Fx29)
+    {
+        this->EmitLoadRegister(EAX, instruction->x);
+        this->Emit(0x8D);
+        this->Emit(0x84);
+        this->Emit(0x80);
+        this->Emit32(Chip8Constants::FONTSET_START_ADDRESS);
+        this->Emit(0x66);
+        this->EmitModRM(0x89, EAX, this->indexOffset);
+    }
+    //  JP addr
+    else if (handler == &Chip8::OP_1nnn)
+    {
+        this->EmitSetPC(instruction->nnn);
+        *endsBlock = true;
+    }
+    //  JP V0, addr:    movzx eax, [V0]; add eax, nnn; mov word [pc], ax
+    else if (handler == &Chip8::OP_Bnnn)
+    {
+        this->EmitLoadRegister(EAX, 0);
+        this->Emit(0x05);
+        this->Emit32(instruction->nnn);
+        this->Emit(0x66);
+        this->EmitModRM(0x89, EAX, this->pcOffset);
+        *endsBlock = true;
+    }
+    //  CALL addr:      stack[sp & 0xF] = next; sp++; pc = nnn
+    else if (handler == &Chip8::OP_2nnn)
+    {
+        this->EmitLoadByte(EAX, this->spOffset);
+        this->Emit(0x83); //  and eax, 0xF
+        this->Emit(0xE0);
+        this->Emit(Chip8Constants::STACK_LEVELS - 1);
+        this->Emit(0x66); //  mov word [rdi + rax * 2 + stack], next
+        this->Emit(0xC7);
+        this->Emit(0x84);
+        this->Emit(0x47);
+        this->Emit32(this->stackOffset);
+        this->Emit16(nextAddress);
+        this->EmitModRM(0x80, 0, this->spOffset);
+        this->Emit(0x01);
+        this->EmitSetPC(instruction->nnn);
+        *endsBlock = true;
+    }
+    //  RET:            sp--; pc = stack[sp & 0xF]
+    else if (handler == &Chip8::OP_00EE)
+    {
+        this->EmitModRM(0x80, 5, this->spOffset);
+        this->Emit(0x01);
+        this->EmitLoadByte(EAX, this->spOffset);
+        this->Emit(0x83); //  and eax, 0xF
+        this->Emit(0xE0);
+        this->Emit(Chip8Constants::STACK_LEVELS - 1);
+        this->Emit(0x0F); //  movzx eax, word [rdi + rax * 2 + stack]
+        this->Emit(0xB7);
+        this->Emit(0x84);
+        this->Emit(0x47);
+        this->Emit32(this->stackOffset);
+        this->Emit(0x66);
+        this->EmitModRM(0x89, EAX, this->pcOffset);
+        *endsBlock = true;
+    }
+    //  SE/SNE Vx, byte:    cmp byte [Vx], kk
+    else if (handler == &Chip8::OP_3xkk || handler == &Chip8::OP_4xkk)
+    {
+        this->Emit(0x31); //  xor eax, eax
+        this->Emit(0xC0);
+        this->EmitModRM(0x80, 7, Vx);
+        this->Emit(instruction->kk);
+        this->EmitSkip((handler == &Chip8::OP_3xkk) ? HostConditions::SETE : HostConditions::SETNE, nextAddress);
+        *endsBlock = true;
+    }
+    //  SE/SNE Vx, Vy:      cmp byte [Vx], cl
+    else if (handler == &Chip8::OP_5xy0 || handler == &Chip8::OP_9xy0)
+    {
+        this->EmitLoadRegister(ECX, instruction->y);
+        this->Emit(0x31); //  xor eax, eax
+        this->Emit(0xC0);
+        this->EmitModRM(0x38, ECX, Vx);
+        this->EmitSkip((handler == &Chip8::OP_5xy0) ? HostConditions::SETE : HostConditions::SETNE, nextAddress);
+        *endsBlock = true;
+    }
+    //  Drawing, the keypad, the timers, randomness and memory writes are left to the interpreter.
+    else
+    {
+        return false;
+    }
+
+    if (*endsBlock)
+    {
+        this->Emit(0xC3); //  ret
+    }
+
+    return true;
+}
+
+//  Native code emitters.
+void Chip8JIT::Emit(uint8_t byte)
+{
+    this->emitBuffer[this->emitUsed++] = byte;
+}
+
+void Chip8JIT::Emit16(uint16_t value)
+{
+    memcpy(this->emitBuffer + this->emitUsed, &value, sizeof(value));
+    this->emitUsed += sizeof(value);
+}
+
+void Chip8JIT::Emit32(uint32_t value)
+{
+    memcpy(this->emitBuffer + this->emitUsed, &value, sizeof(value));
+    this->emitUsed += sizeof(value);
+}
+
+/***
+ *  EmitModRM:
+ *      Emits an instruction which its memory operand is the `Chip8` state at the given offset, i.e. [rdi + offset].
+ *
+ *  @param opcode   The instruction opcode.
+ *  @param reg      The register operand, or the opcode extension.
+ *  @param offset   The offset of the state out of the `Chip8` pointer.
+ ***/
+void Chip8JIT::EmitModRM(uint8_t opcode, uint8_t reg, int32_t offset)
+{
+    this->Emit(opcode);
+    this->Emit(0x80 | (reg << 3) | HostRegisters::RDI);
+    this->Emit32(offset);
+}
+
+//  movzx hostReg, byte [offset]
+void Chip8JIT::EmitLoadByte(uint8_t hostReg, int32_t offset)
+{
+    this->Emit(0x0F);
+    this->EmitModRM(0xB6, hostReg, offset);
+}
+
+//  movzx hostReg, byte [Vx]
+void Chip8JIT::EmitLoadRegister(uint8_t hostReg, uint8_t Vx)
+{
+    this->EmitLoadByte(hostReg, this->registersOffset + Vx);
+}
+
+//  mov word [pc], address
+void Chip8JIT::EmitSetPC(uint16_t address)
+{
+    this->Emit(0x66);
+    this->EmitModRM(0xC7, 0, this->pcOffset);
+    this->Emit16(address);
+}
+
+//  setcc al; lea eax, [rax * 2 + next]; mov word [pc], ax
+void Chip8JIT::EmitSkip(uint8_t setcc, uint16_t nextAddress)
+{
+    this->Emit(0x0F);
+    this->Emit(setcc);
+    this->Emit(0xC0);
+    this->Emit(0x8D);
+    this->Emit(0x04);
+    this->Emit(0x45);
+    this->Emit32(nextAddress);
+    this->Emit(0x66);
+    this->EmitModRM(0x89, HostRegisters::EAX, this->pcOffset);
+}
@@ -0,0 +1,92 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "Chip8.h"
+
+//  The JIT emits x86-64 code, on any other host every instruction is left to the interpreter.
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+#define CHIP8_JIT_SUPPORTED 1
+#else
+#define CHIP8_JIT_SUPPORTED 0
+#endif
+
+namespace Chip8JITConstants
+{
+    //  The longest basic block translated, in instructions.
+    constexpr uint16_t MAX_BLOCK_INSTRUCTIONS = 64;
+
+    //  The size of the executable buffer holding the translated blocks.
+    constexpr size_t CODE_BUFFER_SIZE = 1 << 20;
+
+    //  The largest amount of native code a single instruction is translated into.
+    constexpr size_t MAX_INSTRUCTION_CODE_SIZE = 48;
+};
+
+class Chip8JIT
+{
+private:
+    //  A translated basic block, the native code runs all of its instructions and sets the `Program Counter`.
+    typedef void (*BlockFunc)(Chip8 *chip);
+
+    struct Block
+    {
+        BlockFunc code;
+        uint16_t instructions;
+        bool translated;
+
+        //  The block may start an idle loop, which is skipped before it runs.
+        bool idle;
+    };
+
+    Chip8 &chip;
+
+    //  Blocks indexed by their starting address.
+    //  A translated block without instructions starts with an operation left to the interpreter.
+    ZeroedTable<Block, Chip8Constants::RAM_SIZE_IN_BYTES> blocks;
+
+    //  The executable buffer and the amount of it already holding code.
+    uint8_t *codeBuffer{};
+    size_t codeUsed{};
+
+    //  The block currently being emitted.
+    uint8_t *emitBuffer{};
+    size_t emitUsed{};
+
+    //  Offsets of the `Chip8` state out of the `Chip8` pointer the blocks get.
+    int32_t registersOffset;
+    int32_t indexOffset;
+    int32_t pcOffset;
+    int32_t stackOffset;
+    int32_t spOffset;
+
+    //  Translates the block starting at the given address.
+    void Translate(uint16_t address, Block *block);
+
+    //  Translates a single decoded instruction, returns false if it is left to the interpreter.
+    bool TranslateInstruction(const Chip8::DecodedInstruction *instruction, uint16_t nextAddress, bool *endsBlock);
+
+    //  Drops every translated block and reuses the whole executable buffer.
+    void Flush();
+
+    //  Native code emitters.
+    void Emit(uint8_t byte);
+    void Emit16(uint16_t value);
+    void Emit32(uint32_t value);
+    void EmitModRM(uint8_t opcode, uint8_t reg, int32_t offset);
+    void EmitLoadByte(uint8_t hostReg, int32_t offset);
+    void EmitLoadRegister(uint8_t hostReg, uint8_t Vx);
+    void EmitSetPC(uint16_t address);
+    void EmitSkip(uint8_t setcc, uint16_t nextAddress);
+
+public:
+    Chip8JIT(Chip8 &chip);
+    ~Chip8JIT();
+
+    //  Executes the given amount of cycles, a block runs only if it fits in the cycles left.
+    void Run(uint64_t cycles);
+
+    //  Drops the blocks translated out of the written memory range.
+    void Invalidate(uint16_t address, uint16_t length);
+};
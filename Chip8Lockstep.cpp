@@ -0,0 +1,911 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "Chip8Lockstep.h"
+#include <algorithm>
+#include <cstring>
+
+//  The AVX2 kernels are compiled for x86 hosts only, and picked at runtime when the CPU supports them.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CHIP8_LOCKSTEP_AVX2 1
+#define AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#else
+#define CHIP8_LOCKSTEP_AVX2 0
+#endif
+
+/***
+ *  Constructor:
+ *      Loads the ROM once, and starts every lane from the same memory image and an empty screen.
+ *
+ *  @param file_path The file path of the Operations.
+ *  @param lanes     The amount of machines stepped together.
+ *  @param seed      The seed of the first lane, every next lane adds one to it.
+ ***/
+Chip8Lockstep::Chip8Lockstep(const char *file_path, size_t lanes, uint64_t seed) : prototype(file_path, Chip8Engine::Threaded),
+                                                                                   lanes(lanes)
+{
+    //  Padding the lanes to whole AVX2 registers, the padding lanes never run.
+    this->paddedLanes = (lanes + Chip8LockstepConstants::LANE_BLOCK - 1) / Chip8LockstepConstants::LANE_BLOCK * Chip8LockstepConstants::LANE_BLOCK;
+
+#if CHIP8_LOCKSTEP_AVX2
+    this->useAVX2 = __builtin_cpu_supports("avx2");
+#else
+    this->useAVX2 = false;
+#endif
+
+    this->registers.assign(Chip8Constants::BASE_REG_AMOUNT * this->paddedLanes, 0);
+    this->index.assign(this->paddedLanes, 0);
+    this->pc.assign(this->paddedLanes, Chip8Constants::START_ADDRESS);
+    this->stack.assign(Chip8Constants::STACK_LEVELS * this->paddedLanes, 0);
+    this->sp.assign(this->paddedLanes, 0);
+    this->delayTimer.assign(this->paddedLanes, 0);
+    this->soundTimer.assign(this->paddedLanes, 0);
+    this->delayTimerCycle.assign(this->paddedLanes, 0);
+    this->soundTimerCycle.assign(this->paddedLanes, 0);
+
+    this->enabled.assign(this->paddedLanes, 0);
+    this->mask16.assign(this->paddedLanes, 0);
+    this->mask8.assign(this->paddedLanes, 0);
+    this->executed.assign(this->paddedLanes, 0);
+    this->divergence.assign(this->paddedLanes, 0);
+
+    this->memory.resize(lanes * Chip8Constants::RAM_SIZE_IN_BYTES);
+    this->keypad.assign(lanes, 0);
+    this->video.assign(lanes * Chip8Constants::VIDEO_HEIGHT, 0);
+    this->scalar.resize(lanes);
+
+    for (size_t lane = 0; lane < lanes; lane++)
+    {
+        memcpy(&this->memory[lane * Chip8Constants::RAM_SIZE_IN_BYTES], this->prototype.memory, Chip8Constants::RAM_SIZE_IN_BYTES);
+        this->randState.push_back(Chip8::SeedState(seed + lane));
+    }
+}
+
+Chip8Lockstep::~Chip8Lockstep()
+{
+}
+
+/***
+ *  Run:
+ *      Executes the given amount of cycles on every lane.
+ *      Each step executes one instruction on all the running lanes which share the lowest `Program Counter`,
+ *      so lanes which fell behind on a branch catch up and join the others again.
+ *      Lanes which keep running in small groups are moved to scalar `Chip8`s, which run after the lockstep lanes.
+ *
+ *  @param cycles The amount of instructions every lane executes.
+ ***/
+void Chip8Lockstep::Run(uint64_t cycles)
+{
+    //  The instruction counters are 32 bit, so long runs are split.
+    constexpr uint64_t maxCycles = UINT32_MAX;
+
+    while (cycles > maxCycles)
+    {
+        this->Run(maxCycles);
+        cycles -= maxCycles;
+    }
+
+    const uint32_t target = cycles;
+
+    for (size_t lane = 0; lane < this->paddedLanes; lane++)
+    {
+        bool running = (lane < this->lanes) && !this->scalar[lane] && (target > 0);
+
+        this->enabled[lane] = running ? 0xFFFF : 0;
+        this->executed[lane] = 0;
+    }
+
+    while (true)
+    {
+        uint16_t address = this->useAVX2 ? this->LowestPCAVX2() : this->LowestPC();
+
+        if (address == 0xFFFF)
+        {
+            break;
+        }
+
+        size_t selected = this->useAVX2 ? this->SelectLanesAVX2(address) : this->SelectLanes(address);
+        size_t leader = 0;
+
+        while (!this->mask8[leader])
+        {
+            leader++;
+        }
+
+        Chip8::DecodedInstruction instruction;
+        uint16_t next = (address + 1) & Chip8Constants::ADDRESS_MASK;
+
+        if (this->written[address] || this->written[next])
+        {
+            //  The opcode might differ between the lanes, lanes which do not match the leader continue alone.
+            const uint8_t *leaderMemory = &this->memory[leader * Chip8Constants::RAM_SIZE_IN_BYTES];
+
+            for (size_t lane = leader + 1; lane < this->lanes; lane++)
+            {
+                const uint8_t *laneMemory = &this->memory[lane * Chip8Constants::RAM_SIZE_IN_BYTES];
+
+                if (this->mask8[lane] && (laneMemory[address] != leaderMemory[address] || laneMemory[next] != leaderMemory[next]))
+                {
+                    this->Deselect(lane);
+                    this->MoveToScalar(lane);
+                    selected--;
+                }
+            }
+
+            this->prototype.DecodeOpcode((leaderMemory[address] << 8u) | leaderMemory[next], &instruction);
+        }
+        else
+        {
+            //  Untouched code is the same in every lane, so it is decoded once out of the ROM image.
+            Chip8::DecodedInstruction *cached = &this->prototype.decodeCache[address];
+
+            if (cached->handler == nullptr)
+            {
+                this->prototype.Decode(address, cached);
+            }
+
+            instruction = *cached;
+        }
+
+        if (this->useAVX2)
+        {
+            this->AdvancePCAVX2();
+        }
+        else
+        {
+            this->AdvancePC();
+        }
+
+        if (!this->useAVX2 || !this->ExecuteAVX2(instruction))
+        {
+            for (size_t lane = 0; lane < this->lanes; lane++)
+            {
+                if (this->mask8[lane])
+                {
+                    this->ExecuteLane(lane, instruction);
+                }
+            }
+        }
+
+        //  Finishing the step with the target of this run.
+        this->target = target;
+
+        if (this->useAVX2)
+        {
+            this->FinishStepAVX2();
+        }
+        else
+        {
+            this->FinishStep();
+        }
+
+        this->AccountDivergence(selected);
+    }
+
+    //  Lanes which diverged run the rest of their cycles alone.
+    for (size_t lane = 0; lane < this->lanes; lane++)
+    {
+        if (this->scalar[lane] && this->executed[lane] < target)
+        {
+            this->scalar[lane]->Run(target - this->executed[lane]);
+        }
+    }
+
+    //  Every lane is at the end of the run now.
+    this->cycles += target;
+    std::fill(this->executed.begin(), this->executed.end(), 0);
+}
+
+size_t Chip8Lockstep::ScalarLanes() const
+{
+    size_t count = 0;
+
+    for (const std::unique_ptr<Chip8> &chip : this->scalar)
+    {
+        count += (chip != nullptr);
+    }
+
+    return count;
+}
+
+uint16_t &Chip8Lockstep::Keypad(size_t lane)
+{
+    if (this->scalar[lane])
+    {
+        return this->scalar[lane]->keypad;
+    }
+
+    return this->keypad[lane];
+}
+
+const uint64_t *Chip8Lockstep::Video(size_t lane) const
+{
+    if (this->scalar[lane])
+    {
+        return this->scalar[lane]->video;
+    }
+
+    return &this->video[lane * Chip8Constants::VIDEO_HEIGHT];
+}
+
+uint8_t Chip8Lockstep::ReadRegister(size_t lane, uint8_t x) const
+{
+    if (this->scalar[lane])
+    {
+        return this->scalar[lane]->Register(x);
+    }
+
+    return this->registers[(x & (Chip8Constants::BASE_REG_AMOUNT - 1)) * this->paddedLanes + lane];
+}
+
+uint8_t Chip8Lockstep::ReadMemory(size_t lane, uint16_t address) const
+{
+    if (this->scalar[lane])
+    {
+        return this->scalar[lane]->ReadMemory(address);
+    }
+
+    return this->memory[lane * Chip8Constants::RAM_SIZE_IN_BYTES + (address & Chip8Constants::ADDRESS_MASK)];
+}
+
+/***
+ *  AccountDivergence:
+ *      Lanes executing in a group too small to be worth a vector step count towards diverging,
+ *      lanes executing in a large group start over.
+ *
+ *  @param selected The amount of lanes which executed the step.
+ ***/
+void Chip8Lockstep::AccountDivergence(size_t selected)
+{
+    size_t vectorLanes = this->lanes - this->ScalarLanes();
+    size_t smallGroup = vectorLanes / Chip8LockstepConstants::SMALL_GROUP_DIVISOR;
+
+    if (selected >= ((smallGroup > 2) ? smallGroup : 2))
+    {
+        for (size_t lane = 0; lane < this->lanes; lane++)
+        {
+            this->divergence[lane] &= ~this->mask8[lane];
+        }
+
+        return;
+    }
+
+    for (size_t lane = 0; lane < this->lanes; lane++)
+    {
+        if (this->mask8[lane] && ++this->divergence[lane] > Chip8LockstepConstants::DIVERGENCE_LIMIT)
+        {
+            this->MoveToScalar(lane);
+        }
+    }
+}
+
+void Chip8Lockstep::Deselect(size_t lane)
+{
+    this->mask8[lane] = 0;
+    this->mask16[lane] = 0;
+}
+
+/***
+ *  MoveToScalar:
+ *      Copies the lane state into a new `Chip8`, and takes the lane out of the lockstep lanes.
+ *
+ *  @param lane The lane to move.
+ ***/
+void Chip8Lockstep::MoveToScalar(size_t lane)
+{
+    std::unique_ptr<Chip8> chip = this->prototype.Fork();
+
+    memcpy(chip->memory, &this->memory[lane * Chip8Constants::RAM_SIZE_IN_BYTES], Chip8Constants::RAM_SIZE_IN_BYTES);
+    chip->keypad = this->keypad[lane];
+    memcpy(chip->video, this->Video(lane), sizeof(chip->video));
+
+    for (uint8_t x = 0; x < Chip8Constants::BASE_REG_AMOUNT; x++)
+    {
+        chip->registers[x] = this->Register(lane, x);
+    }
+
+    for (uint8_t level = 0; level < Chip8Constants::STACK_LEVELS; level++)
+    {
+        chip->stack[level] = this->stack[level * this->paddedLanes + lane];
+    }
+
+    chip->index = this->index[lane];
+    chip->pc = this->pc[lane];
+    chip->sp = this->sp[lane];
+    chip->delayTimer = this->delayTimer[lane];
+    chip->soundTimer = this->soundTimer[lane];
+    chip->delayTimerCycle = this->delayTimerCycle[lane];
+    chip->soundTimerCycle = this->soundTimerCycle[lane];
+    chip->cycles = this->cycles + this->executed[lane];
+    chip->instructionsPerFrame = this->instructionsPerFrame;
+    chip->randState = this->randState[lane];
+
+    this->scalar[lane] = std::move(chip);
+    this->enabled[lane] = 0;
+}
+
+uint8_t Chip8Lockstep::TimerValue(size_t lane, uint8_t value, uint64_t setCycle) const
+{
+    uint64_t ticks = (this->cycles + this->executed[lane]) / this->instructionsPerFrame - setCycle / this->instructionsPerFrame;
+
+    return (ticks < value) ? value - ticks : 0;
+}
+
+void Chip8Lockstep::WriteMemory(size_t lane, uint16_t address, uint8_t value)
+{
+    address &= Chip8Constants::ADDRESS_MASK;
+
+    this->memory[lane * Chip8Constants::RAM_SIZE_IN_BYTES + address] = value;
+    this->written[address] = 1;
+}
+
+/***
+ *  ExecuteLane:
+ *      Executes the instruction on a single lane, with the same behavior as the `Chip8` operations.
+ *      The `Program Counter` was already moved past the opcode.
+ *
+ *  @param lane         The lane to execute on.
+ *  @param instruction  The decoded instruction.
+ ***/
+void Chip8Lockstep::ExecuteLane(size_t lane, const Chip8::DecodedInstruction &instruction)
+{
+    typedef Chip8::Operation Operation;
+
+    uint8_t *laneMemory = &this->memory[lane * Chip8Constants::RAM_SIZE_IN_BYTES];
+    uint16_t laneKeypad = this->keypad[lane];
+    uint64_t *laneVideo = &this->video[lane * Chip8Constants::VIDEO_HEIGHT];
+    uint16_t &lanePC = this->pc[lane];
+    uint16_t &laneIndex = this->index[lane];
+    uint8_t &laneSP = this->sp[lane];
+    uint8_t &Vx = this->Register(lane, instruction.x);
+    uint8_t &Vy = this->Register(lane, instruction.y);
+    uint8_t &VF = this->Register(lane, 0xF);
+
+    switch (instruction.operation)
+    {
+    case Operation::OP_NULL:
+        break;
+
+    case Operation::OP_00E0:
+        memset(laneVideo, 0, Chip8Constants::VIDEO_HEIGHT * sizeof(laneVideo[0]));
+        break;
+
+    case Operation::OP_00EE:
+        --laneSP;
+        lanePC = this->stack[(laneSP & (Chip8Constants::STACK_LEVELS - 1)) * this->paddedLanes + lane] & Chip8Constants::ADDRESS_MASK;
+        break;
+
+    case Operation::OP_1nnn:
+        lanePC = instruction.nnn;
+        break;
+
+    case Operation::OP_2nnn:
+        this->stack[(laneSP & (Chip8Constants::STACK_LEVELS - 1)) * this->paddedLanes + lane] = lanePC;
+        ++laneSP;
+        lanePC = instruction.nnn;
+        break;
+
+    case Operation::OP_3xkk:
+        lanePC += (Vx == instruction.kk) ? 2 : 0;
+        break;
+
+    case Operation::OP_4xkk:
+        lanePC += (Vx != instruction.kk) ? 2 : 0;
+        break;
+
+    case Operation::OP_5xy0:
+        lanePC += (Vx == Vy) ? 2 : 0;
+        break;
+
+    case Operation::OP_9xy0:
+        lanePC += (Vx != Vy) ? 2 : 0;
+        break;
+
+    case Operation::OP_6xkk:
+        Vx = instruction.kk;
+        break;
+
+    case Operation::OP_7xkk:
+        Vx += instruction.kk;
+        break;
+
+    case Operation::OP_8xy0:
+        Vx = Vy;
+        break;
+
+    case Operation::OP_8xy1:
+        Vx |= Vy;
+        break;
+
+    case Operation::OP_8xy2:
+        Vx &= Vy;
+        break;
+
+    case Operation::OP_8xy3:
+        Vx ^= Vy;
+        break;
+
+    case Operation::OP_8xy4:
+    {
+        uint16_t sum = Vx + Vy;
+        VF = (sum > UINT8_MAX);
+        Vx = sum & 0xFFu;
+    }
+    break;
+
+    case Operation::OP_8xy5:
+        VF = (Vx > Vy);
+        Vx -= Vy;
+        break;
+
+    case Operation::OP_8xy7:
+        VF = (Vy > Vx);
+        Vx -= Vy;
+        break;
+
+    case Operation::OP_8xy6:
+        VF = (Vx & 0x1u);
+        Vx >>= 1;
+        break;
+
+    case Operation::OP_8xyE:
+        VF = (Vx & 0x80u) >> 0x7u;
+        Vx <<= 1;
+        break;
+
+    case Operation::OP_Annn:
+        laneIndex = instruction.nnn;
+        break;
+
+    case Operation::OP_Bnnn:
+        lanePC = (this->Register(lane, 0) + instruction.nnn) & Chip8Constants::ADDRESS_MASK;
+        break;
+
+    case Operation::OP_Cxkk:
+        Vx = Chip8::NextRandomByte(this->randState[lane]) & instruction.kk;
+        break;
+
+    case Operation::OP_Dxyn:
+    {
+        uint8_t xPos = Vx % Chip8Constants::VIDEO_WIDTH;
+        uint8_t yPos = Vy % Chip8Constants::VIDEO_HEIGHT;
+        uint8_t height = instruction.n;
+        bool collision = false;
+
+        if (height > Chip8Constants::VIDEO_HEIGHT - yPos)
+        {
+            height = Chip8Constants::VIDEO_HEIGHT - yPos;
+        }
+
+        for (size_t row = 0; row < height; row++)
+        {
+            uint8_t spriteByte = laneMemory[(laneIndex + row) & Chip8Constants::ADDRESS_MASK];
+            uint64_t spriteRow = (uint64_t(spriteByte) << (Chip8Constants::VIDEO_WIDTH - Chip8Constants::BYTE_SIZE)) >> xPos;
+
+            collision |= (laneVideo[yPos + row] & spriteRow) != 0;
+            laneVideo[yPos + row] ^= spriteRow;
+        }
+
+        VF = collision ? 1 : 0;
+    }
+    break;
+
+    //  Keys past the keypad are never pressed.
+    case Operation::OP_Ex9E:
+        lanePC += (Vx < Chip8Constants::AMOUNT_OF_CHARS && ((laneKeypad >> Vx) & 1u)) ? 2 : 0;
+        break;
+
+    case Operation::OP_ExA1:
+        lanePC += !(Vx < Chip8Constants::AMOUNT_OF_CHARS && ((laneKeypad >> Vx) & 1u)) ? 2 : 0;
+        break;
+
+    case Operation::OP_Fx07:
+        Vx = this->TimerValue(lane, this->delayTimer[lane], this->delayTimerCycle[lane]);
+        break;
+
+    case Operation::OP_Fx0A:
+        if (laneKeypad == 0)
+        {
+            lanePC = (lanePC - 2) & Chip8Constants::ADDRESS_MASK;
+        }
+        else
+        {
+            Vx = __builtin_ctz(laneKeypad);
+        }
+        break;
+
+    case Operation::OP_Fx15:
+        this->delayTimer[lane] = Vx;
+        this->delayTimerCycle[lane] = this->cycles + this->executed[lane];
+        break;
+
+    case Operation::OP_Fx18:
+        this->soundTimer[lane] = Vx;
+        this->soundTimerCycle[lane] = this->cycles + this->executed[lane];
+        break;
+
+    case Operation::OP_Fx1E:
+        laneIndex += Vx;
+        break;
+
+    case Operation::OP_Fx29:
+        laneIndex = Chip8Constants::FONTSET_START_ADDRESS + (5 * Vx);
+        break;
+
+    case Operation::OP_Fx33:
+    {
+        uint8_t value = Vx;
+
+        this->WriteMemory(lane, laneIndex + 2, value % 10);
+        this->WriteMemory(lane, laneIndex + 1, value % 100);
+        this->WriteMemory(lane, laneIndex, value % 1000);
+    }
+    break;
+
+    case Operation::OP_Fx55:
+        for (size_t i = 0; i < instruction.x; i++)
+        {
+            this->WriteMemory(lane, laneIndex + i, this->Register(lane, i));
+        }
+        break;
+
+    case Operation::OP_Fx65:
+        for (size_t i = 0; i < instruction.x; i++)
+        {
+            this->Register(lane, i) = laneMemory[(laneIndex + i) & Chip8Constants::ADDRESS_MASK];
+        }
+        break;
+
+    //  Only the threaded dispatch uses these, `operation` always holds the operation itself.
+    case Operation::OP_IdleJump:
+    case Operation::OP_Annn_Dxyn:
+    case Operation::OP_6xkk_6xkk:
+    case Operation::OP_3xkk_1nnn:
+    case Operation::OP_4xkk_1nnn:
+    case Operation::OP_Fx07_3xkk_1nnn:
+        __builtin_unreachable();
+    }
+}
+
+/********************
+ *  Scalar stepping *
+ ********************/
+uint16_t Chip8Lockstep::LowestPC()
+{
+    uint16_t lowest = 0xFFFF;
+
+    for (size_t lane = 0; lane < this->paddedLanes; lane++)
+    {
+        if (this->enabled[lane] && this->pc[lane] < lowest)
+        {
+            lowest = this->pc[lane];
+        }
+    }
+
+    return lowest;
+}
+
+size_t Chip8Lockstep::SelectLanes(uint16_t address)
+{
+    size_t selected = 0;
+
+    for (size_t lane = 0; lane < this->paddedLanes; lane++)
+    {
+        bool running = this->enabled[lane] && this->pc[lane] == address;
+
+        this->mask16[lane] = running ? 0xFFFF : 0;
+        this->mask8[lane] = running ? 0xFF : 0;
+        selected += running;
+    }
+
+    return selected;
+}
+
+void Chip8Lockstep::AdvancePC()
+{
+    for (size_t lane = 0; lane < this->paddedLanes; lane++)
+    {
+        if (this->mask8[lane])
+        {
+            this->pc[lane] = (this->pc[lane] + 2) & Chip8Constants::ADDRESS_MASK;
+        }
+    }
+}
+
+void Chip8Lockstep::FinishStep()
+{
+    for (size_t lane = 0; lane < this->paddedLanes; lane++)
+    {
+        if (this->mask8[lane])
+        {
+            //  The `Program Counter` of the lanes stays inside the memory, as all their fetches are.
+            this->pc[lane] &= Chip8Constants::ADDRESS_MASK;
+
+            if (++this->executed[lane] == this->target)
+            {
+                this->enabled[lane] = 0;
+            }
+        }
+    }
+}
+
+/******************
+ *  AVX2 stepping *
+ ******************/
+#if CHIP8_LOCKSTEP_AVX2
+AVX2_TARGET uint16_t Chip8Lockstep::LowestPCAVX2()
+{
+    __m256i lowest = _mm256_set1_epi16(-1);
+
+    //  Lanes which are not running take part as 0xFFFF.
+    for (size_t lane = 0; lane < this->paddedLanes; lane += 16)
+    {
+        __m256i lanePC = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&this->pc[lane]));
+        __m256i running = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&this->enabled[lane]));
+
+        lowest = _mm256_min_epu16(lowest, _mm256_or_si256(lanePC, _mm256_xor_si256(running, _mm256_set1_epi16(-1))));
+    }
+
+    __m128i half = _mm_min_epu16(_mm256_castsi256_si128(lowest), _mm256_extracti128_si256(lowest, 1));
+
+    return _mm_extract_epi16(_mm_minpos_epu16(half), 0);
+}
+
+AVX2_TARGET size_t Chip8Lockstep::SelectLanesAVX2(uint16_t address)
+{
+    const __m256i wanted = _mm256_set1_epi16(address);
+    size_t selected = 0;
+
+    for (size_t lane = 0; lane < this->paddedLanes; lane += 32)
+    {
+        __m256i low = _mm256_and_si256(_mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(&this->pc[lane])), wanted),
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&this->enabled[lane])));
+        __m256i high = _mm256_and_si256(_mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(&this->pc[lane + 16])), wanted),
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&this->enabled[lane + 16])));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&this->mask16[lane]), low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&this->mask16[lane + 16]), high);
+
+        //  Packing works inside each 128 bit half, so the quarters are put back in lane order.
+        __m256i bytes = _mm256_permute4x64_epi64(_mm256_packs_epi16(low, high), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&this->mask8[lane]), bytes);
+
+        selected += __builtin_popcount(_mm256_movemask_epi8(bytes));
+    }
+
+    return selected;
+}
+
+AVX2_TARGET void Chip8Lockstep::AdvancePCAVX2()
+{
+    const __m256i two = _mm256_set1_epi16(2);
+    const __m256i addressMask = _mm256_set1_epi16(Chip8Constants::ADDRESS_MASK);
+
+    for (size_t lane = 0; lane < this->paddedLanes; lane += 16)
+    {
+        __m256i *lanePC = reinterpret_cast<__m256i *>(&this->pc[lane]);
+        __m256i selected = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&this->mask16[lane]));
+
+        _mm256_storeu_si256(lanePC, _mm256_and_si256(_mm256_add_epi16(_mm256_loadu_si256(lanePC), _mm256_and_si256(selected, two)), addressMask));
+    }
+}
+
+AVX2_TARGET void Chip8Lockstep::FinishStepAVX2()
+{
+    const __m256i addressMask = _mm256_set1_epi16(Chip8Constants::ADDRESS_MASK);
+    const __m256i wanted = _mm256_set1_epi32(this->target);
+
+    for (size_t lane = 0; lane < this->paddedLanes; lane += 16)
+    {
+        __m256i *lanePC = reinterpret_cast<__m256i *>(&this->pc[lane]);
+        _mm256_storeu_si256(lanePC, _mm256_and_si256(_mm256_loadu_si256(lanePC), addressMask));
+
+        //  A selected lane byte is -1, so subtracting it counts the instruction.
+        __m256i *low = reinterpret_cast<__m256i *>(&this->executed[lane]);
+        __m256i *high = reinterpret_cast<__m256i *>(&this->executed[lane + 8]);
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&this->mask8[lane]));
+
+        __m256i lowCount = _mm256_sub_epi32(_mm256_loadu_si256(low), _mm256_cvtepi8_epi32(bytes));
+        __m256i highCount = _mm256_sub_epi32(_mm256_loadu_si256(high), _mm256_cvtepi8_epi32(_mm_srli_si128(bytes, 8)));
+
+        _mm256_storeu_si256(low, lowCount);
+        _mm256_storeu_si256(high, highCount);
+
+        //  Lanes which reached the target stop running.
+        __m256i done = _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_cmpeq_epi32(lowCount, wanted),
+                                                                   _mm256_cmpeq_epi32(highCount, wanted)),
+                                                0xD8);
+        __m256i *running = reinterpret_cast<__m256i *>(&this->enabled[lane]);
+        _mm256_storeu_si256(running, _mm256_andnot_si256(done, _mm256_loadu_si256(running)));
+    }
+}
+
+/***
+ *  ExecuteAVX2:
+ *      Executes the register, index and `Program Counter` operations on all the selected lanes at once,
+ *      32 lanes per AVX2 register for the `V` registers and 16 lanes for the 16 bit state.
+ *      Unselected lanes keep their values through the blends.
+ *
+ *  @param instruction  The decoded instruction.
+ *
+ *  @return             False if the operation is left to `ExecuteLane`.
+ ***/
+AVX2_TARGET bool Chip8Lockstep::ExecuteAVX2(const Chip8::DecodedInstruction &instruction)
+{
+    typedef Chip8::Operation Operation;
+
+    uint8_t *Vx = &this->registers[instruction.x * this->paddedLanes];
+    uint8_t *Vy = &this->registers[instruction.y * this->paddedLanes];
+    uint8_t *VF = &this->registers[0xF * this->paddedLanes];
+
+    const __m256i kk = _mm256_set1_epi8(instruction.kk);
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i ones = _mm256_set1_epi8(-1);
+
+#define LOAD(pointer) _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pointer))
+#define STORE(pointer, value) _mm256_storeu_si256(reinterpret_cast<__m256i *>(pointer), value)
+
+    //  Runs the body over 32 byte lanes at a time, with `selected` holding their byte mask.
+#define FOR_BYTE_LANES(body)                                          \
+    for (size_t lane = 0; lane < this->paddedLanes; lane += 32)       \
+    {                                                                 \
+        __m256i selected = LOAD(&this->mask8[lane]);                  \
+        body                                                          \
+    }
+
+    //  Runs the body over 16 word lanes at a time, with `selected` holding their word mask.
+#define FOR_WORD_LANES(body)                                          \
+    for (size_t lane = 0; lane < this->paddedLanes; lane += 16)       \
+    {                                                                 \
+        __m256i selected = LOAD(&this->mask16[lane]);                 \
+        body                                                          \
+    }
+
+    switch (instruction.operation)
+    {
+    case Operation::OP_NULL:
+        break;
+
+    case Operation::OP_6xkk:
+        FOR_BYTE_LANES(STORE(Vx + lane, _mm256_blendv_epi8(LOAD(Vx + lane), kk, selected));)
+        break;
+
+    case Operation::OP_7xkk:
+        FOR_BYTE_LANES(__m256i x = LOAD(Vx + lane);
+                       STORE(Vx + lane, _mm256_blendv_epi8(x, _mm256_add_epi8(x, kk), selected));)
+        break;
+
+    case Operation::OP_8xy0:
+        FOR_BYTE_LANES(STORE(Vx + lane, _mm256_blendv_epi8(LOAD(Vx + lane), LOAD(Vy + lane), selected));)
+        break;
+
+    case Operation::OP_8xy1:
+        FOR_BYTE_LANES(__m256i x = LOAD(Vx + lane);
+                       STORE(Vx + lane, _mm256_blendv_epi8(x, _mm256_or_si256(x, LOAD(Vy + lane)), selected));)
+        break;
+
+    case Operation::OP_8xy2:
+        FOR_BYTE_LANES(__m256i x = LOAD(Vx + lane);
+                       STORE(Vx + lane, _mm256_blendv_epi8(x, _mm256_and_si256(x, LOAD(Vy + lane)), selected));)
+        break;
+
+    case Operation::OP_8xy3:
+        FOR_BYTE_LANES(__m256i x = LOAD(Vx + lane);
+                       STORE(Vx + lane, _mm256_blendv_epi8(x, _mm256_xor_si256(x, LOAD(Vy + lane)), selected));)
+        break;
+
+    //  The flag is stored before the result, and the registers are loaded again after it,
+    //  so X or Y being F behaves as in the `Chip8` operations.
+    case Operation::OP_8xy4:
+        FOR_BYTE_LANES(__m256i x = LOAD(Vx + lane);
+                       __m256i y = LOAD(Vy + lane);
+                       __m256i sum = _mm256_add_epi8(x, y);
+                       __m256i carry = _mm256_andnot_si256(_mm256_cmpeq_epi8(_mm256_adds_epu8(x, y), sum), one);
+                       STORE(VF + lane, _mm256_blendv_epi8(LOAD(VF + lane), carry, selected));
+                       STORE(Vx + lane, _mm256_blendv_epi8(LOAD(Vx + lane), sum, selected));)
+        break;
+
+    case Operation::OP_8xy5:
+    case Operation::OP_8xy7:
+    {
+        bool reversed = (instruction.operation == Operation::OP_8xy7);
+
+        FOR_BYTE_LANES(__m256i x = LOAD(Vx + lane);
+                       __m256i y = LOAD(Vy + lane);
+                       __m256i larger = _mm256_max_epu8(x, y);
+                       __m256i flag = _mm256_andnot_si256(_mm256_cmpeq_epi8(larger, reversed ? x : y), one);
+                       STORE(VF + lane, _mm256_blendv_epi8(LOAD(VF + lane), flag, selected));
+                       x = LOAD(Vx + lane);
+                       STORE(Vx + lane, _mm256_blendv_epi8(x, _mm256_sub_epi8(x, LOAD(Vy + lane)), selected));)
+    }
+    break;
+
+    case Operation::OP_8xy6:
+        FOR_BYTE_LANES(STORE(VF + lane, _mm256_blendv_epi8(LOAD(VF + lane), _mm256_and_si256(LOAD(Vx + lane), one), selected));
+                       __m256i x = LOAD(Vx + lane);
+                       __m256i shifted = _mm256_and_si256(_mm256_srli_epi16(x, 1), _mm256_set1_epi8(0x7F));
+                       STORE(Vx + lane, _mm256_blendv_epi8(x, shifted, selected));)
+        break;
+
+    case Operation::OP_8xyE:
+        FOR_BYTE_LANES(__m256i flag = _mm256_and_si256(_mm256_srli_epi16(LOAD(Vx + lane), 7), one);
+                       STORE(VF + lane, _mm256_blendv_epi8(LOAD(VF + lane), flag, selected));
+                       __m256i x = LOAD(Vx + lane);
+                       STORE(Vx + lane, _mm256_blendv_epi8(x, _mm256_add_epi8(x, x), selected));)
+        break;
+
+    case Operation::OP_3xkk:
+    case Operation::OP_4xkk:
+    case Operation::OP_5xy0:
+    case Operation::OP_9xy0:
+    {
+        bool immediate = (instruction.operation == Operation::OP_3xkk || instruction.operation == Operation::OP_4xkk);
+        bool notEqual = (instruction.operation == Operation::OP_4xkk || instruction.operation == Operation::OP_9xy0);
+        const __m256i two = _mm256_set1_epi16(2);
+
+        for (size_t lane = 0; lane < this->paddedLanes; lane += 32)
+        {
+            __m256i equal = _mm256_cmpeq_epi8(LOAD(Vx + lane), immediate ? kk : LOAD(Vy + lane));
+            __m256i skip = notEqual ? _mm256_xor_si256(equal, ones) : equal;
+
+            //  Widening the byte conditions to the 16 bit `Program Counter` lanes.
+            __m256i low = _mm256_and_si256(_mm256_cvtepi8_epi16(_mm256_castsi256_si128(skip)), LOAD(&this->mask16[lane]));
+            __m256i high = _mm256_and_si256(_mm256_cvtepi8_epi16(_mm256_extracti128_si256(skip, 1)), LOAD(&this->mask16[lane + 16]));
+
+            STORE(&this->pc[lane], _mm256_add_epi16(LOAD(&this->pc[lane]), _mm256_and_si256(low, two)));
+            STORE(&this->pc[lane + 16], _mm256_add_epi16(LOAD(&this->pc[lane + 16]), _mm256_and_si256(high, two)));
+        }
+    }
+    break;
+
+    case Operation::OP_1nnn:
+    {
+        const __m256i address = _mm256_set1_epi16(instruction.nnn);
+
+        FOR_WORD_LANES(STORE(&this->pc[lane], _mm256_blendv_epi8(LOAD(&this->pc[lane]), address, selected));)
+    }
+    break;
+
+    case Operation::OP_Annn:
+    {
+        const __m256i address = _mm256_set1_epi16(instruction.nnn);
+
+        FOR_WORD_LANES(STORE(&this->index[lane], _mm256_blendv_epi8(LOAD(&this->index[lane]), address, selected));)
+    }
+    break;
+
+    case Operation::OP_Fx1E:
+        FOR_WORD_LANES(__m256i x = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(Vx + lane)));
+                       STORE(&this->index[lane], _mm256_add_epi16(LOAD(&this->index[lane]), _mm256_and_si256(x, selected)));)
+        break;
+
+    case Operation::OP_Fx29:
+    {
+        const __m256i fontHeight = _mm256_set1_epi16(Chip8Constants::FONT_HEIGHT);
+        const __m256i fontStart = _mm256_set1_epi16(Chip8Constants::FONTSET_START_ADDRESS);
+
+        FOR_WORD_LANES(__m256i x = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(Vx + lane)));
+                       __m256i address = _mm256_add_epi16(_mm256_mullo_epi16(x, fontHeight), fontStart);
+                       STORE(&this->index[lane], _mm256_blendv_epi8(LOAD(&this->index[lane]), address, selected));)
+    }
+    break;
+
+    default:
+        return false;
+    }
+
+#undef FOR_WORD_LANES
+#undef FOR_BYTE_LANES
+#undef STORE
+#undef LOAD
+
+    return true;
+}
+#else
+uint16_t Chip8Lockstep::LowestPCAVX2() { return this->LowestPC(); }
+size_t Chip8Lockstep::SelectLanesAVX2(uint16_t address) { return this->SelectLanes(address); }
+void Chip8Lockstep::AdvancePCAVX2() { this->AdvancePC(); }
+void Chip8Lockstep::FinishStepAVX2() { this->FinishStep(); }
+bool Chip8Lockstep::ExecuteAVX2(const Chip8::DecodedInstruction &instruction) { return false; }
+#endif
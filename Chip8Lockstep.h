@@ -0,0 +1,127 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "Chip8.h"
+#include <vector>
+
+namespace Chip8LockstepConstants
+{
+    //  Lanes are stored padded to the amount of byte lanes in an AVX2 register.
+    constexpr size_t LANE_BLOCK = 32;
+
+    //  A group of lanes sharing a `Program Counter` smaller than this part of the vector lanes is a small group.
+    constexpr size_t SMALL_GROUP_DIVISOR = 32;
+
+    //  The amount of steps a lane may run in small groups, before it is moved to a scalar `Chip8`.
+    constexpr uint8_t DIVERGENCE_LIMIT = 32;
+};
+
+class Chip8Lockstep
+{
+private:
+    //  Holds the ROM image every lane starts from, decodes the opcodes shared by the lanes,
+    //  and is forked for the lanes moving to a scalar `Chip8`.
+    Chip8 prototype;
+
+    size_t lanes;
+    size_t paddedLanes;
+    bool useAVX2;
+
+    //  The machines state as structure of arrays, each array is indexed by the lane,
+    //  and arrays of several values are stored value after value, e.g. `registers[x * paddedLanes + lane]`.
+    std::vector<uint8_t> registers;
+    std::vector<uint16_t> index;
+    std::vector<uint16_t> pc;
+    std::vector<uint16_t> stack;
+    std::vector<uint8_t> sp;
+    std::vector<uint8_t> delayTimer;
+    std::vector<uint8_t> soundTimer;
+    std::vector<uint64_t> delayTimerCycle;
+    std::vector<uint64_t> soundTimerCycle;
+
+    //  State which is only accessed one lane at a time, stored lane after lane.
+    std::vector<uint8_t> memory;
+    std::vector<uint16_t> keypad;
+    std::vector<uint64_t> video;
+    std::vector<uint64_t> randState;
+
+    //  Addresses any lane has written to, opcodes fetched out of them are compared between the lanes.
+    uint8_t written[Chip8Constants::RAM_SIZE_IN_BYTES]{};
+
+    //  Lanes which moved to a scalar `Chip8` after diverging, `nullptr` for lanes still stepped in lockstep.
+    std::vector<std::unique_ptr<Chip8>> scalar;
+
+    //  Per step bookkeeping: lanes still running this `Run`, lanes executing the current step,
+    //  instructions executed this `Run` and steps spent in small groups.
+    std::vector<uint16_t> enabled;
+    std::vector<uint16_t> mask16;
+    std::vector<uint8_t> mask8;
+    std::vector<uint32_t> executed;
+    std::vector<uint8_t> divergence;
+
+    //  The amount of instructions every lane executes in the current `Run`.
+    uint32_t target{};
+
+    //  The instructions the lockstep lanes executed before the current `Run`, and the length of their frames.
+    //  A lane is at cycle `cycles + executed[lane]`.
+    uint64_t cycles{};
+    uint32_t instructionsPerFrame{Chip8Constants::DEFAULT_INSTRUCTIONS_PER_FRAME};
+
+    //  Finds the lowest `Program Counter` of the running lanes, 0xFFFF if none are running.
+    uint16_t LowestPC();
+    uint16_t LowestPCAVX2();
+
+    //  Selects the running lanes at the given address, returns how many there are.
+    size_t SelectLanes(uint16_t address);
+    size_t SelectLanesAVX2(uint16_t address);
+
+    //  Moves the selected lanes past the opcode, and accounts the executed instruction after it ran.
+    void AdvancePC();
+    void AdvancePCAVX2();
+    void FinishStep();
+    void FinishStepAVX2();
+
+    //  Executes the instruction on the selected lanes, the AVX2 version returns false for operations it leaves to `ExecuteLane`.
+    bool ExecuteAVX2(const Chip8::DecodedInstruction &instruction);
+    void ExecuteLane(size_t lane, const Chip8::DecodedInstruction &instruction);
+
+    //  Updates the divergence of the selected lanes, moving lanes which diverged too far to a scalar `Chip8`.
+    void AccountDivergence(size_t selected);
+
+    //  Drops a lane out of the current step.
+    void Deselect(size_t lane);
+
+    //  Copies a lane state into a new scalar `Chip8`, which executes it from then on.
+    void MoveToScalar(size_t lane);
+
+    //  Writes a byte into a lane memory, remembering the address was written.
+    void WriteMemory(size_t lane, uint16_t address, uint8_t value);
+
+    //  Computes a lane timer value out of the value written and the cycle it was written at, as `Chip8` does.
+    uint8_t TimerValue(size_t lane, uint8_t value, uint64_t setCycle) const;
+
+    uint8_t &Register(size_t lane, uint8_t x) { return this->registers[x * this->paddedLanes + lane]; }
+
+public:
+    //  Starts the given amount of lanes out of the same ROM, lane `i` is seeded with `seed + i`.
+    Chip8Lockstep(const char *file_path, size_t lanes, uint64_t seed);
+    ~Chip8Lockstep();
+
+    //  Executes the given amount of cycles on every lane.
+    void Run(uint64_t cycles);
+
+    size_t Lanes() const { return this->lanes; }
+
+    //  The amount of lanes executed by scalar `Chip8`s after diverging.
+    size_t ScalarLanes() const;
+
+    //  The keypad mask and video of a lane, the references move when the lane moves to a scalar `Chip8`.
+    uint16_t &Keypad(size_t lane);
+    const uint64_t *Video(size_t lane) const;
+
+    //  A register and a memory byte of a lane, read out of the scalar `Chip8` once the lane moved to one.
+    uint8_t ReadRegister(size_t lane, uint8_t x) const;
+    uint8_t ReadMemory(size_t lane, uint16_t address) const;
+};
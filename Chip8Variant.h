@@ -0,0 +1,839 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "Chip8.h"
+#include "ROMCache.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Chip8VariantConstants
+{
+    //  The low resolution every variant starts in.
+    constexpr uint8_t LORES_WIDTH = 64;
+    constexpr uint8_t LORES_HEIGHT = 32;
+
+    //  The large font of the high resolution variants, a digit being 8 by 10 pixels.
+    constexpr uint8_t BIG_FONT_HEIGHT = 10;
+    constexpr uint16_t BIG_FONTSET_START_ADDRESS = 0xA0;
+
+    constexpr uint8_t bigFontset[Chip8Constants::AMOUNT_OF_CHARS * BIG_FONT_HEIGHT] =
+        {
+            0xFF, 0xFF, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, // 0
+            0x18, 0x78, 0x78, 0x18, 0x18, 0x18, 0x18, 0x18, 0xFF, 0xFF, // 1
+            0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, // 2
+            0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, // 3
+            0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03, 0x03, 0x03, // 4
+            0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, // 5
+            0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, // 6
+            0xFF, 0xFF, 0x03, 0x03, 0x06, 0x0C, 0x18, 0x18, 0x18, 0x18, // 7
+            0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, // 8
+            0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, // 9
+            0x7E, 0xFF, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xC3, // A
+            0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC, // B
+            0x3C, 0xFF, 0xC3, 0xC0, 0xC0, 0xC0, 0xC0, 0xC3, 0xFF, 0x3C, // C
+            0xFC, 0xFE, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFE, 0xFC, // D
+            0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, // E
+            0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xC0, 0xC0  // F
+    };
+};
+
+//  The platform and quirks a `Chip8Variant` is built for, every value is resolved at compile time.
+//  A policy with other quirks derives from one of these and hides the values it changes.
+//  The base is the original COSMAC VIP interpreter, whose shift, load, store and VF quirks are not the ones of `Chip8`:
+//  `Chip8` shifts Vx, keeps VF on the logic operations, and loads and stores the registers below x without moving the index.
+struct VIPPolicy
+{
+    //  The screen in its highest resolution, the memory size and the amount of bit planes.
+    static constexpr uint8_t WIDTH = 64;
+    static constexpr uint8_t HEIGHT = 32;
+    static constexpr uint32_t MEMORY_SIZE = 4096;
+    static constexpr uint8_t PLANES = 1;
+
+    //  `8xy6` and `8xyE` shift Vy into Vx, instead of shifting Vx.
+    static constexpr bool SHIFT_USES_VY = true;
+
+    //  `Fx55` and `Fx65` leave the `Index Register` after the last register.
+    static constexpr bool LOAD_STORE_INCREMENTS_INDEX = true;
+
+    //  `Bxnn` jumps by Vx instead of V0.
+    static constexpr bool JUMP_USES_VX = false;
+
+    //  `8xy1`, `8xy2` and `8xy3` clear VF.
+    static constexpr bool LOGIC_RESETS_VF = true;
+
+    //  Sprites crossing the screen edges continue at the opposite edge, instead of being clipped.
+    static constexpr bool WRAP_SPRITES = false;
+
+    //  The SCHIP instructions: high resolution, scrolling, 16 by 16 sprites, the large font and the flag registers.
+    static constexpr bool HIRES = false;
+    static constexpr uint8_t FLAG_REGISTERS = 0;
+
+    //  The XO-CHIP instructions: bit planes, 16 bit addresses, register ranges and scrolling up.
+    //  The audio pattern and pitch are not emulated, `F002` and `Fx3A` do nothing.
+    static constexpr bool XO = false;
+};
+
+struct SChipPolicy : VIPPolicy
+{
+    static constexpr uint8_t WIDTH = 128;
+    static constexpr uint8_t HEIGHT = 64;
+
+    static constexpr bool SHIFT_USES_VY = false;
+    static constexpr bool LOAD_STORE_INCREMENTS_INDEX = false;
+    static constexpr bool JUMP_USES_VX = true;
+    static constexpr bool LOGIC_RESETS_VF = false;
+
+    static constexpr bool HIRES = true;
+    static constexpr uint8_t FLAG_REGISTERS = 8;
+};
+
+struct XOChipPolicy : VIPPolicy
+{
+    static constexpr uint8_t WIDTH = 128;
+    static constexpr uint8_t HEIGHT = 64;
+    static constexpr uint32_t MEMORY_SIZE = 65536;
+    static constexpr uint8_t PLANES = 2;
+
+    static constexpr bool LOGIC_RESETS_VF = false;
+    static constexpr bool WRAP_SPRITES = true;
+
+    static constexpr bool HIRES = true;
+    static constexpr uint8_t FLAG_REGISTERS = 16;
+    static constexpr bool XO = true;
+};
+
+//  An interpreter specialized for a platform and its quirks at compile time, so no operation branches on them.
+//  It runs the programs of the variants `Chip8` does not: the VIP quirks, the SCHIP 128 by 64 screen with scrolling,
+//  and the XO-CHIP 64 KB memory and bit planes.
+//  It is kept apart from `Chip8` as the JIT, AOT and lockstep engines, the recompiler and the recordings all rely
+//  on the fixed `Chip8State` of a 4 KB memory and a 64 by 32 screen. It therefore has none of their speedups,
+//  only the plain fetch, decode and execute loop.
+template <typename Policy>
+class Chip8Variant
+{
+private:
+    static_assert(Policy::WIDTH == 64 || Policy::WIDTH == 128, "A screen row is packed into a 64 or 128 bit word.");
+    static_assert(Policy::HEIGHT <= 64 && Policy::PLANES >= 1 && Policy::PLANES <= 2, "The screen fits the planes.");
+    static_assert((Policy::MEMORY_SIZE & (Policy::MEMORY_SIZE - 1)) == 0 && Policy::MEMORY_SIZE <= 65536,
+                  "The memory is addressed by a mask.");
+    static_assert(Policy::FLAG_REGISTERS <= Chip8Constants::BASE_REG_AMOUNT, "The flag registers back up registers.");
+
+public:
+    //  A screen row, the leftmost pixel is the highest bit.
+    typedef typename std::conditional<(Policy::WIDTH > 64), unsigned __int128, uint64_t>::type Row;
+
+private:
+    static constexpr uint8_t ROW_BITS = sizeof(Row) * Chip8Constants::BYTE_SIZE;
+    static constexpr uint32_t ADDRESS_MASK = Policy::MEMORY_SIZE - 1;
+
+    uint8_t registers[Chip8Constants::BASE_REG_AMOUNT]{};
+    uint8_t memory[Policy::MEMORY_SIZE]{};
+    uint16_t index{};
+    uint16_t pc{Chip8Constants::START_ADDRESS};
+    uint16_t stack[Chip8Constants::STACK_LEVELS]{};
+    uint8_t sp{};
+
+    //  The timers tick every frame of instructions.
+    uint8_t delayTimer{};
+    uint8_t soundTimer{};
+    uint64_t cycles{};
+    uint32_t instructionsPerFrame{Chip8Constants::DEFAULT_INSTRUCTIONS_PER_FRAME};
+
+    uint16_t keypad{};
+    uint64_t randState;
+
+    //  The high resolution mode, the program having exited, and the planes drawn to.
+    bool hires{false};
+    bool halted{false};
+    uint8_t planeMask{1};
+
+    //  The SCHIP flag registers.
+    uint8_t flags[Chip8Constants::BASE_REG_AMOUNT]{};
+
+    //  The planes of the screen, the low resolution uses their top left corner.
+    Row video[Policy::PLANES][Policy::HEIGHT]{};
+
+    uint16_t Fetch(uint32_t address) const;
+    void Execute(uint16_t opcode);
+
+    //  Skips the next instruction, which is 4 bytes long for the XO-CHIP `F000 nnnn`.
+    void Skip();
+
+    //  The operations which differ between the variants.
+    void Operation0(uint16_t opcode);
+    void Operation8(uint8_t x, uint8_t y, uint8_t n);
+    void OperationF(uint8_t x, uint8_t kk);
+    void Draw(uint8_t x, uint8_t y, uint8_t n);
+    void Scroll(int8_t rows, int8_t columns);
+    void ClearPlanes(uint8_t planes);
+
+    //  The bits of the columns of the screen at its current resolution.
+    Row ScreenMask() const;
+
+public:
+    Chip8Variant(const char *file_path);
+
+    //  Fetches, decodes and executes a single instruction, and ticks the timers at the end of a frame.
+    void Cycle();
+
+    //  Executes the given amount of cycles, or until the program exits.
+    void Run(uint64_t cycles);
+
+    //  Reads the machine state, for tools scoring or inspecting it.
+    uint8_t Register(uint8_t x) const { return this->registers[x & (Chip8Constants::BASE_REG_AMOUNT - 1)]; }
+    uint8_t ReadMemory(uint32_t address) const { return this->memory[address & ADDRESS_MASK]; }
+    uint16_t Index() const { return this->index; }
+    uint8_t DelayTimer() const { return this->delayTimer; }
+    uint8_t SoundTimer() const { return this->soundTimer; }
+    uint64_t Cycles() const { return this->cycles; }
+    bool Halted() const { return this->halted; }
+
+    //  The screen at its current resolution, and the plane bits of a pixel.
+    uint8_t Width() const { return this->hires ? Policy::WIDTH : Chip8VariantConstants::LORES_WIDTH; }
+    uint8_t Height() const { return this->hires ? Policy::HEIGHT : Chip8VariantConstants::LORES_HEIGHT; }
+    uint8_t Pixel(uint8_t x, uint8_t y) const;
+
+    void Seed(uint64_t seed) { this->randState = Chip8::SeedState(seed); }
+    uint16_t KeypadMask() const { return this->keypad; }
+    void SetKeypadMask(uint16_t keys) { this->keypad = keys; }
+
+    //  Sets the amount of instructions in a frame, throws invalid_argument for 0, as `Chip8` does.
+    void SetInstructionsPerFrame(uint32_t instructionsPerFrame);
+};
+
+typedef Chip8Variant<VIPPolicy> Chip8VIP;
+typedef Chip8Variant<SChipPolicy> SChip;
+typedef Chip8Variant<XOChipPolicy> XOChip;
+
+/***
+ *  Chip8Variant:
+ *      Constructor, loads the fonts and the ROM, the randomness is seeded with 0 so runs are reproducible.
+ *      A missing file leaves the memory empty, as `Chip8` does.
+ *
+ *  @param file_path The ROM file.
+ ***/
+template <typename Policy>
+Chip8Variant<Policy>::Chip8Variant(const char *file_path)
+    : randState(Chip8::SeedState(0))
+{
+    memcpy(this->memory + Chip8Constants::FONTSET_START_ADDRESS, Chip8Constants::fontset, sizeof(Chip8Constants::fontset));
+
+    if constexpr (Policy::HIRES)
+    {
+        memcpy(this->memory + Chip8VariantConstants::BIG_FONTSET_START_ADDRESS,
+               Chip8VariantConstants::bigFontset,
+               sizeof(Chip8VariantConstants::bigFontset));
+    }
+
+    std::shared_ptr<const ROMImage> image = ROMCache::Instance().Load(file_path);
+
+    if (image != nullptr)
+    {
+        if (image->size > Policy::MEMORY_SIZE - Chip8Constants::START_ADDRESS)
+        {
+            printf("Aborting, `ROM` file is bigger than the variant's memory.\n");
+            throw std::overflow_error("ROM is bigger than the variant's memory.");
+        }
+
+        memcpy(this->memory + Chip8Constants::START_ADDRESS, image->bytes, image->size);
+    }
+}
+
+template <typename Policy>
+uint16_t Chip8Variant<Policy>::Fetch(uint32_t address) const
+{
+    return (this->memory[address & ADDRESS_MASK] << 8u) | this->memory[(address + 1) & ADDRESS_MASK];
+}
+
+template <typename Policy>
+void Chip8Variant<Policy>::Cycle()
+{
+    if (this->halted)
+    {
+        return;
+    }
+
+    uint16_t opcode = this->Fetch(this->pc);
+
+    this->pc += 2;
+    this->Execute(opcode);
+
+    //  Ticking the timers once every frame of instructions.
+    if (++this->cycles % this->instructionsPerFrame == 0)
+    {
+        this->delayTimer -= (this->delayTimer > 0);
+        this->soundTimer -= (this->soundTimer > 0);
+    }
+}
+
+template <typename Policy>
+void Chip8Variant<Policy>::SetInstructionsPerFrame(uint32_t instructionsPerFrame)
+{
+    if (instructionsPerFrame == 0)
+    {
+        throw std::invalid_argument("A frame must hold at least one instruction.");
+    }
+
+    this->instructionsPerFrame = instructionsPerFrame;
+}
+
+template <typename Policy>
+void Chip8Variant<Policy>::Run(uint64_t cycles)
+{
+    for (uint64_t i = 0; i < cycles && !this->halted; i++)
+    {
+        this->Cycle();
+    }
+}
+
+template <typename Policy>
+void Chip8Variant<Policy>::Skip()
+{
+    if constexpr (Policy::XO)
+    {
+        if (this->Fetch(this->pc) == 0xF000u)
+        {
+            this->pc += 2;
+        }
+    }
+
+    this->pc += 2;
+}
+
+/***
+ *  Execute:
+ *      Decodes the opcode and executes it. The operations every variant shares are executed here,
+ *      and operations a variant does not have do nothing.
+ *
+ *  @param opcode The opcode to execute.
+ ***/
+template <typename Policy>
+void Chip8Variant<Policy>::Execute(uint16_t opcode)
+{
+    uint8_t x = (opcode & 0x0F00u) >> 8u;
+    uint8_t y = (opcode & 0x00F0u) >> 4u;
+    uint8_t n = opcode & 0x000Fu;
+    uint8_t kk = opcode & 0x00FFu;
+    uint16_t nnn = opcode & 0x0FFFu;
+    uint8_t &Vx = this->registers[x];
+    uint8_t &Vy = this->registers[y];
+
+    switch (opcode >> 12u)
+    {
+    case 0x0:
+        this->Operation0(opcode);
+        break;
+
+    case 0x1:
+        this->pc = nnn;
+        break;
+
+    case 0x2:
+        this->stack[this->sp & (Chip8Constants::STACK_LEVELS - 1)] = this->pc;
+        this->sp++;
+        this->pc = nnn;
+        break;
+
+    case 0x3:
+        if (Vx == kk)
+        {
+            this->Skip();
+        }
+        break;
+
+    case 0x4:
+        if (Vx != kk)
+        {
+            this->Skip();
+        }
+        break;
+
+    case 0x5:
+        if (n == 0x0 && Vx == Vy)
+        {
+            this->Skip();
+        }
+
+        //  XO-CHIP saves and loads the registers from Vx to Vy, in either order, leaving the `Index Register`.
+        if constexpr (Policy::XO)
+        {
+            if (n == 0x2 || n == 0x3)
+            {
+                int8_t step = (x <= y) ? 1 : -1;
+
+                for (uint8_t i = 0, r = x;; i++, r += step)
+                {
+                    if (n == 0x2)
+                    {
+                        this->memory[(this->index + i) & ADDRESS_MASK] = this->registers[r];
+                    }
+                    else
+                    {
+                        this->registers[r] = this->memory[(this->index + i) & ADDRESS_MASK];
+                    }
+
+                    if (r == y)
+                    {
+                        break;
+                    }
+                }
+            }
+        }
+        break;
+
+    case 0x6:
+        Vx = kk;
+        break;
+
+    case 0x7:
+        Vx += kk;
+        break;
+
+    case 0x8:
+        this->Operation8(x, y, n);
+        break;
+
+    case 0x9:
+        if (n == 0x0 && Vx != Vy)
+        {
+            this->Skip();
+        }
+        break;
+
+    case 0xA:
+        this->index = nnn;
+        break;
+
+    case 0xB:
+        if constexpr (Policy::JUMP_USES_VX)
+        {
+            this->pc = nnn + Vx;
+        }
+        else
+        {
+            this->pc = nnn + this->registers[0x0];
+        }
+        break;
+
+    case 0xC:
+        Vx = Chip8::NextRandomByte(this->randState) & kk;
+        break;
+
+    case 0xD:
+        this->Draw(Vx, Vy, n);
+        break;
+
+    case 0xE:
+    {
+        //  Keys past the keypad are never pressed.
+        bool pressed = Vx < Chip8Constants::AMOUNT_OF_CHARS && ((this->keypad >> Vx) & 1u);
+
+        if ((kk == 0x9E && pressed) || (kk == 0xA1 && !pressed))
+        {
+            this->Skip();
+        }
+    }
+    break;
+
+    case 0xF:
+        this->OperationF(x, kk);
+        break;
+    }
+}
+
+/***
+ *  Operation0:
+ *      Clears the screen and returns, and in the high resolution variants scrolls, exits and switches resolution.
+ *
+ *  @param opcode The opcode, starting with 0.
+ ***/
+template <typename Policy>
+void Chip8Variant<Policy>::Operation0(uint16_t opcode)
+{
+    if (opcode == 0x00E0u)
+    {
+        this->ClearPlanes(this->planeMask);
+    }
+    else if (opcode == 0x00EEu)
+    {
+        this->sp--;
+        this->pc = this->stack[this->sp & (Chip8Constants::STACK_LEVELS - 1)];
+    }
+
+    if constexpr (Policy::HIRES)
+    {
+        if ((opcode & 0xFFF0u) == 0x00C0u)
+        {
+            this->Scroll(opcode & 0x000Fu, 0);
+        }
+        else if (opcode == 0x00FBu)
+        {
+            this->Scroll(0, 4);
+        }
+        else if (opcode == 0x00FCu)
+        {
+            this->Scroll(0, -4);
+        }
+        else if (opcode == 0x00FDu)
+        {
+            this->halted = true;
+        }
+        else if (opcode == 0x00FEu || opcode == 0x00FFu)
+        {
+            //  Switching the resolution clears the whole screen.
+            this->hires = (opcode == 0x00FFu);
+            this->ClearPlanes((1u << Policy::PLANES) - 1);
+        }
+    }
+
+    if constexpr (Policy::XO)
+    {
+        if ((opcode & 0xFFF0u) == 0x00D0u)
+        {
+            this->Scroll(-(opcode & 0x000F), 0);
+        }
+    }
+}
+
+/***
+ *  Operation8:
+ *      The register operations, VF is written last so it holds the flag even when it is Vx.
+ *
+ *  @param x    The destination register.
+ *  @param y    The source register.
+ *  @param n    The operation.
+ ***/
+template <typename Policy>
+void Chip8Variant<Policy>::Operation8(uint8_t x, uint8_t y, uint8_t n)
+{
+    uint8_t &Vx = this->registers[x];
+    uint8_t Vy = this->registers[y];
+    uint8_t &VF = this->registers[0xF];
+    uint8_t shifted = Policy::SHIFT_USES_VY ? Vy : Vx;
+    uint8_t flag;
+
+    switch (n)
+    {
+    case 0x0:
+        Vx = Vy;
+        return;
+
+    case 0x1:
+        Vx |= Vy;
+        break;
+
+    case 0x2:
+        Vx &= Vy;
+        break;
+
+    case 0x3:
+        Vx ^= Vy;
+        break;
+
+    case 0x4:
+        flag = (Vx + Vy) > 0xFF;
+        Vx += Vy;
+        VF = flag;
+        return;
+
+    case 0x5:
+        flag = Vx >= Vy;
+        Vx -= Vy;
+        VF = flag;
+        return;
+
+    case 0x6:
+        flag = shifted & 0x1u;
+        Vx = shifted >> 1u;
+        VF = flag;
+        return;
+
+    case 0x7:
+        flag = Vy >= Vx;
+        Vx = Vy - Vx;
+        VF = flag;
+        return;
+
+    case 0xE:
+        flag = shifted >> 7u;
+        Vx = shifted << 1u;
+        VF = flag;
+        return;
+
+    default:
+        return;
+    }
+
+    if constexpr (Policy::LOGIC_RESETS_VF)
+    {
+        VF = 0;
+    }
+}
+
+/***
+ *  OperationF:
+ *      The timer, keypad, font, memory and the variants own operations starting with F.
+ *
+ *  @param x    The register, or the planes for `Fn01`.
+ *  @param kk   The operation.
+ ***/
+template <typename Policy>
+void Chip8Variant<Policy>::OperationF(uint8_t x, uint8_t kk)
+{
+    uint8_t &Vx = this->registers[x];
+
+    switch (kk)
+    {
+    case 0x07:
+        Vx = this->delayTimer;
+        break;
+
+    case 0x0A:
+        //  Waiting for the lowest pressed key.
+        if (this->keypad == 0)
+        {
+            this->pc -= 2;
+        }
+        else
+        {
+            Vx = __builtin_ctz(this->keypad);
+        }
+        break;
+
+    case 0x15:
+        this->delayTimer = Vx;
+        break;
+
+    case 0x18:
+        this->soundTimer = Vx;
+        break;
+
+    case 0x1E:
+        this->index = (this->index + Vx) & ADDRESS_MASK;
+        break;
+
+    case 0x29:
+        this->index = Chip8Constants::FONTSET_START_ADDRESS + Chip8Constants::FONT_HEIGHT * (Vx & 0xFu);
+        break;
+
+    case 0x33:
+        this->memory[this->index & ADDRESS_MASK] = Vx / 100;
+        this->memory[(this->index + 1) & ADDRESS_MASK] = (Vx / 10) % 10;
+        this->memory[(this->index + 2) & ADDRESS_MASK] = Vx % 10;
+        break;
+
+    case 0x55:
+    case 0x65:
+        for (uint8_t i = 0; i <= x; i++)
+        {
+            if (kk == 0x55)
+            {
+                this->memory[(this->index + i) & ADDRESS_MASK] = this->registers[i];
+            }
+            else
+            {
+                this->registers[i] = this->memory[(this->index + i) & ADDRESS_MASK];
+            }
+        }
+
+        if constexpr (Policy::LOAD_STORE_INCREMENTS_INDEX)
+        {
+            this->index = (this->index + x + 1) & ADDRESS_MASK;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if constexpr (Policy::HIRES)
+    {
+        uint8_t count = (x < Policy::FLAG_REGISTERS) ? x + 1 : Policy::FLAG_REGISTERS;
+
+        if (kk == 0x30)
+        {
+            this->index = Chip8VariantConstants::BIG_FONTSET_START_ADDRESS + Chip8VariantConstants::BIG_FONT_HEIGHT * (Vx & 0xFu);
+        }
+        else if (kk == 0x75)
+        {
+            memcpy(this->flags, this->registers, count);
+        }
+        else if (kk == 0x85)
+        {
+            memcpy(this->registers, this->flags, count);
+        }
+    }
+
+    if constexpr (Policy::XO)
+    {
+        if (x == 0x0 && kk == 0x00)
+        {
+            //  `F000 nnnn` loads the 16 bit address following it.
+            this->index = this->Fetch(this->pc);
+            this->pc += 2;
+        }
+        else if (kk == 0x01)
+        {
+            this->planeMask = x & ((1u << Policy::PLANES) - 1);
+        }
+    }
+}
+
+template <typename Policy>
+typename Chip8Variant<Policy>::Row Chip8Variant<Policy>::ScreenMask() const
+{
+    uint8_t width = this->Width();
+
+    return (width == ROW_BITS) ? ~Row(0) : ~(~Row(0) >> width);
+}
+
+/***
+ *  Draw:
+ *      Draws a sprite to every selected plane, each plane taking the rows after the previous plane's.
+ *      The high resolution variants draw a 16 by 16 sprite for a height of 0.
+ *      VF is raised if any pixel is turned off.
+ *
+ *  @param x        The column of the sprite, wrapped to the screen.
+ *  @param y        The row of the sprite, wrapped to the screen.
+ *  @param height   The amount of sprite rows.
+ ***/
+template <typename Policy>
+void Chip8Variant<Policy>::Draw(uint8_t x, uint8_t y, uint8_t height)
+{
+    uint8_t width = this->Width();
+    uint8_t screenHeight = this->Height();
+    bool large = Policy::HIRES && height == 0;
+    uint8_t spriteWidth = large ? 16 : 8;
+    uint8_t rows = large ? 16 : height;
+    uint32_t address = this->index;
+    Row mask = this->ScreenMask();
+    bool collision = false;
+
+    x %= width;
+    y %= screenHeight;
+
+    for (uint8_t plane = 0; plane < Policy::PLANES; plane++)
+    {
+        if ((this->planeMask & (1u << plane)) == 0)
+        {
+            continue;
+        }
+
+        for (uint8_t row = 0; row < rows; row++, address += spriteWidth / Chip8Constants::BYTE_SIZE)
+        {
+            uint8_t screenRow = y + row;
+
+            if (screenRow >= screenHeight)
+            {
+                if constexpr (!Policy::WRAP_SPRITES)
+                {
+                    continue;
+                }
+
+                screenRow -= screenHeight;
+            }
+
+            uint16_t bits = large ? this->Fetch(address) : this->memory[address & ADDRESS_MASK];
+            Row line = Row(bits) << (ROW_BITS - spriteWidth);
+            Row placed = line >> x;
+
+            //  Pixels past the right edge continue at the left edge, or are clipped.
+            if constexpr (Policy::WRAP_SPRITES)
+            {
+                Row wrapped = (x == 0) ? 0 : line << (ROW_BITS - x);
+
+                if (width < ROW_BITS)
+                {
+                    wrapped |= (placed & ~mask) << width;
+                }
+
+                placed = (placed & mask) | wrapped;
+            }
+            else
+            {
+                placed &= mask;
+            }
+
+            collision |= (this->video[plane][screenRow] & placed) != 0;
+            this->video[plane][screenRow] ^= placed;
+        }
+    }
+
+    this->registers[0xF] = collision ? 1 : 0;
+}
+
+/***
+ *  Scroll:
+ *      Scrolls the selected planes by pixels of the current resolution, the pixels scrolled in are off.
+ *
+ *  @param rows     The rows to scroll down, negative to scroll up.
+ *  @param columns  The columns to scroll right, negative to scroll left.
+ ***/
+template <typename Policy>
+void Chip8Variant<Policy>::Scroll(int8_t rows, int8_t columns)
+{
+    int height = this->Height();
+    Row mask = this->ScreenMask();
+
+    for (uint8_t plane = 0; plane < Policy::PLANES; plane++)
+    {
+        if ((this->planeMask & (1u << plane)) == 0)
+        {
+            continue;
+        }
+
+        Row *screen = this->video[plane];
+
+        //  Moving the rows in the order which reads every row before it is overwritten.
+        for (int i = 0; i < height; i++)
+        {
+            int row = (rows > 0) ? height - 1 - i : i;
+            int source = row - rows;
+
+            screen[row] = (source >= 0 && source < height) ? screen[source] : 0;
+        }
+
+        for (int row = 0; row < height; row++)
+        {
+            screen[row] = ((columns >= 0) ? (screen[row] >> columns) : (screen[row] << -columns)) & mask;
+        }
+    }
+}
+
+template <typename Policy>
+void Chip8Variant<Policy>::ClearPlanes(uint8_t planes)
+{
+    for (uint8_t plane = 0; plane < Policy::PLANES; plane++)
+    {
+        if (planes & (1u << plane))
+        {
+            memset(this->video[plane], 0, sizeof(this->video[plane]));
+        }
+    }
+}
+
+/***
+ *  Pixel:
+ *      Reads a pixel of the screen at its current resolution.
+ *
+ *  @param x    The column.
+ *  @param y    The row.
+ *
+ *  @return     A bit per plane, bit `i` set when the pixel is on in plane `i`.
+ ***/
+template <typename Policy>
+uint8_t Chip8Variant<Policy>::Pixel(uint8_t x, uint8_t y) const
+{
+    uint8_t bits = 0;
+
+    for (uint8_t plane = 0; plane < Policy::PLANES; plane++)
+    {
+        bits |= ((this->video[plane][y % this->Height()] >> (ROW_BITS - 1 - x % this->Width())) & 1u) << plane;
+    }
+
+    return bits;
+}
@@ -0,0 +1,48 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "FrameBuffer.h"
+#include <cstring>
+
+/***
+ *  Publish:
+ *      Fills the back frame and swaps it with the middle one. When the frame swapped out was never
+ *      taken by the consumer, its changed rows are carried into the next frame, so no change is lost.
+ *
+ *  @param video        The bit packed screen.
+ *  @param dirtyRows    The rows changed since the last published frame.
+ *  @param cycles       The amount of instructions executed so far.
+ ***/
+void FrameBuffer::Publish(const uint64_t *video, uint32_t dirtyRows, uint64_t cycles)
+{
+    VideoFrame &frame = this->frames[this->back];
+
+    memcpy(frame.video, video, sizeof(frame.video));
+    frame.dirtyRows = dirtyRows | this->skippedRows;
+    frame.cycles = cycles;
+
+    //  Releasing the frame contents along with the index, and acquiring the contents of the frame given back.
+    uint8_t previous = this->middle.exchange(this->back | FRESH, std::memory_order_acq_rel);
+
+    this->back = previous & INDEX_MASK;
+    this->skippedRows = (previous & FRESH) ? this->frames[this->back].dirtyRows : 0;
+}
+
+/***
+ *  Acquire:
+ *      Swaps the front frame with the middle one, when the middle one was published since the last call.
+ *
+ *  @return The newest frame, which stays valid until the next call, or `nullptr` when nothing new was published.
+ ***/
+const VideoFrame *FrameBuffer::Acquire()
+{
+    //  Only the producer marks the middle frame, so it stays fresh until the exchange.
+    if ((this->middle.load(std::memory_order_relaxed) & FRESH) == 0)
+    {
+        return nullptr;
+    }
+
+    this->front = this->middle.exchange(this->front, std::memory_order_acq_rel) & INDEX_MASK;
+
+    return &this->frames[this->front];
+}
@@ -0,0 +1,49 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "Chip8.h"
+#include <atomic>
+
+//  A completed screen, handed from the emulation thread to the render thread.
+struct alignas(64) VideoFrame
+{
+    uint64_t video[Chip8Constants::VIDEO_HEIGHT];
+
+    //  The rows changed since the last frame the render thread took, frames it never took included.
+    uint32_t dirtyRows;
+
+    //  The amount of instructions executed when the frame was published.
+    uint64_t cycles;
+};
+
+//  A lock-free triple buffer of frames between a single producer and a single consumer.
+//  The producer fills the back frame and swaps it with the middle one, the consumer swaps
+//  the middle frame with the front one only when a newer frame was published. Neither side waits.
+class FrameBuffer
+{
+private:
+    //  Marks the middle frame as published after the consumer took the last one.
+    static constexpr uint8_t FRESH = 0x4;
+    static constexpr uint8_t INDEX_MASK = 0x3;
+
+    VideoFrame frames[3]{};
+
+    //  The middle frame, exchanged by both sides.
+    alignas(64) std::atomic<uint8_t> middle{1};
+
+    //  Owned by the producer: the frame being filled, and the rows of a published frame the consumer skipped.
+    alignas(64) uint8_t back{0};
+    uint32_t skippedRows{};
+
+    //  Owned by the consumer: the frame being presented.
+    alignas(64) uint8_t front{2};
+
+public:
+    //  Called by the producer, copies the screen into the back frame and publishes it.
+    void Publish(const uint64_t *video, uint32_t dirtyRows, uint64_t cycles);
+
+    //  Called by the consumer, takes the newest published frame, or returns `nullptr` when there is none newer.
+    const VideoFrame *Acquire();
+};
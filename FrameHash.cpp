@@ -0,0 +1,115 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "FrameHash.h"
+
+//  The AVX2 version is compiled for x86 hosts only.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CHIP8_FRAME_HASH_AVX2 1
+#define AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#else
+#define CHIP8_FRAME_HASH_AVX2 0
+#endif
+
+//  The key of each row, so equal rows at different positions hash differently.
+struct RowKeys
+{
+    alignas(32) uint64_t keys[Chip8Constants::VIDEO_HEIGHT];
+
+    RowKeys()
+    {
+        for (size_t row = 0; row < Chip8Constants::VIDEO_HEIGHT; row++)
+        {
+            this->keys[row] = (row + 1) * FrameHashConstants::PRIME;
+        }
+    }
+};
+
+static const RowKeys rowKeys;
+
+static uint64_t FinishHash(const uint64_t *lanes);
+
+/***
+ *  HashFrameScalar:
+ *      Accumulates every row in one of four lanes, the row of the lane `i` going to the lane `i % 4`.
+ *      Each row keyed by its position adds the product of its two halves and the row itself,
+ *      which are the 32 bit multiplications AVX2 does four at a time.
+ *
+ *  @param video    The screen rows.
+ *
+ *  @return         The hash of the screen.
+ ***/
+uint64_t HashFrameScalar(const uint64_t *video)
+{
+    uint64_t lanes[FrameHashConstants::ROWS_PER_BLOCK] = {};
+
+    for (size_t row = 0; row < Chip8Constants::VIDEO_HEIGHT; row++)
+    {
+        uint64_t keyed = video[row] ^ rowKeys.keys[row];
+
+        lanes[row % FrameHashConstants::ROWS_PER_BLOCK] += (keyed & 0xFFFFFFFFu) * (keyed >> 32) + video[row];
+    }
+
+    return FinishHash(lanes);
+}
+
+#if CHIP8_FRAME_HASH_AVX2
+AVX2_TARGET static uint64_t HashFrameAVX2(const uint64_t *video)
+{
+    __m256i accumulator = _mm256_setzero_si256();
+
+    for (size_t row = 0; row < Chip8Constants::VIDEO_HEIGHT; row += FrameHashConstants::ROWS_PER_BLOCK)
+    {
+        __m256i rows = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(video + row));
+        __m256i keyed = _mm256_xor_si256(rows, _mm256_load_si256(reinterpret_cast<const __m256i *>(rowKeys.keys + row)));
+        __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+
+        accumulator = _mm256_add_epi64(accumulator, _mm256_add_epi64(product, rows));
+    }
+
+    alignas(32) uint64_t lanes[FrameHashConstants::ROWS_PER_BLOCK];
+
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), accumulator);
+
+    return FinishHash(lanes);
+}
+#endif
+
+uint64_t HashFrame(const uint64_t *video)
+{
+#if CHIP8_FRAME_HASH_AVX2
+    static const bool useAVX2 = __builtin_cpu_supports("avx2");
+
+    if (useAVX2)
+    {
+        return HashFrameAVX2(video);
+    }
+#endif
+
+    return HashFrameScalar(video);
+}
+
+/***
+ *  FinishHash:
+ *      Folds the lanes into one hash, mixing after each lane so every bit of them reaches every bit of the hash.
+ *
+ *  @param lanes    The four accumulated lanes.
+ *
+ *  @return         The hash.
+ ***/
+static uint64_t FinishHash(const uint64_t *lanes)
+{
+    uint64_t hash = Chip8Constants::VIDEO_HEIGHT * FrameHashConstants::PRIME;
+
+    for (size_t lane = 0; lane < FrameHashConstants::ROWS_PER_BLOCK; lane++)
+    {
+        //  The SplitMix64 finalizer.
+        hash ^= lanes[lane];
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+        hash ^= hash >> 31;
+    }
+
+    return hash;
+}
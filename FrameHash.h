@@ -0,0 +1,24 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "Chip8.h"
+
+namespace FrameHashConstants
+{
+    //  The rows are hashed four at a time, a 256 bit register of rows.
+    constexpr uint8_t ROWS_PER_BLOCK = 4;
+
+    constexpr uint64_t PRIME = 0x9E3779B97F4A7C15ull;
+};
+
+static_assert(Chip8Constants::VIDEO_HEIGHT % FrameHashConstants::ROWS_PER_BLOCK == 0, "The screen is hashed in whole blocks of rows.");
+
+//  Hashes a screen, the rows being mixed with a key of their position so moved pixels change the hash.
+//  The AVX2 version is picked at runtime when the CPU supports it, both give the same hash,
+//  so hashes recorded on one machine are compared on any other.
+uint64_t HashFrame(const uint64_t *video);
+
+//  The portable version of `HashFrame`.
+uint64_t HashFrameScalar(const uint64_t *video);
@@ -0,0 +1,255 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "FrameRecorder.h"
+#include "Varint.h"
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+//  The byte of a screen holding 8 pixels, the bytes of each row ordered from its leftmost pixel.
+static uint8_t FrameByte(const uint64_t *video, size_t position)
+{
+    return video[position / sizeof(uint64_t)] >> (56 - 8 * (position % sizeof(uint64_t)));
+}
+
+/***
+ *  FrameRecorder:
+ *      Constructor, opens the file, writes the header of the format and starts the encoder thread.
+ *
+ *  @param file_path    The file to write.
+ *  @param format       The format of the file.
+ ***/
+FrameRecorder::FrameRecorder(const char *file_path, FrameFormat format)
+    : file(file_path, std::ios::binary | std::ios::trunc),
+      format(format)
+{
+    if (!this->file.is_open())
+    {
+        throw std::runtime_error("Could not open the frame recording for writing.");
+    }
+
+    if (format == FrameFormat::Y4M)
+    {
+        this->file << "YUV4MPEG2 W" << int(Chip8Constants::VIDEO_WIDTH)
+                   << " H" << int(Chip8Constants::VIDEO_HEIGHT)
+                   << " F" << FrameRecorderConstants::FRAMES_PER_SECOND << ":1 Ip A1:1 Cmono\n";
+    }
+    else
+    {
+        this->file.write(FrameRecorderConstants::MAGIC, sizeof(FrameRecorderConstants::MAGIC));
+        this->file.put(FrameRecorderConstants::VERSION);
+        this->file.put(Chip8Constants::VIDEO_WIDTH);
+        this->file.put(Chip8Constants::VIDEO_HEIGHT);
+    }
+
+    this->encoder = std::thread(&FrameRecorder::EncoderLoop, this);
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    this->stopping.store(true, std::memory_order_release);
+    this->encoder.join();
+}
+
+/***
+ *  Push:
+ *      Copies the screen into the queue, the copy being all the emulation thread pays for a frame.
+ *
+ *  @param video    The bit packed screen.
+ *  @param cycles   The amount of instructions executed so far.
+ *
+ *  @return         `false` if the queue was full and the screen was dropped.
+ ***/
+bool FrameRecorder::Push(const uint64_t *video, uint64_t cycles)
+{
+    VideoFrame frame;
+
+    memcpy(frame.video, video, sizeof(frame.video));
+    frame.dirtyRows = 0;
+    frame.cycles = cycles;
+
+    if (!this->frames.Push(frame))
+    {
+        this->dropped++;
+
+        return false;
+    }
+
+    return true;
+}
+
+void FrameRecorder::EncoderLoop()
+{
+    while (true)
+    {
+        //  Reading the flag before the queue, so every screen pushed before stopping is still written.
+        bool stop = this->stopping.load(std::memory_order_acquire);
+        VideoFrame *frame = this->frames.Front();
+
+        if (frame == nullptr)
+        {
+            if (stop)
+            {
+                break;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        if (this->format == FrameFormat::Y4M)
+        {
+            this->WriteY4M(frame->video);
+        }
+        else
+        {
+            this->WriteDelta(frame->video);
+        }
+
+        this->frames.Pop();
+    }
+
+    this->file.flush();
+}
+
+/***
+ *  WriteY4M:
+ *      Writes a frame of a byte per pixel, off pixels black and on pixels white.
+ *
+ *  @param video    The bit packed screen.
+ ***/
+void FrameRecorder::WriteY4M(const uint64_t *video)
+{
+    static constexpr char FRAME_HEADER[] = "FRAME\n";
+
+    this->encoded.resize(Chip8Constants::VIDEO_WIDTH * Chip8Constants::VIDEO_HEIGHT);
+
+    for (size_t row = 0; row < Chip8Constants::VIDEO_HEIGHT; row++)
+    {
+        for (size_t column = 0; column < Chip8Constants::VIDEO_WIDTH; column++)
+        {
+            this->encoded[row * Chip8Constants::VIDEO_WIDTH + column] = ((video[row] >> (63 - column)) & 1u) ? 0xFF : 0x00;
+        }
+    }
+
+    this->file.write(FRAME_HEADER, sizeof(FRAME_HEADER) - 1);
+    this->file.write(reinterpret_cast<const char *>(this->encoded.data()), this->encoded.size());
+}
+
+/***
+ *  WriteDelta:
+ *      Writes the frame as the XOR against the previous frame, in runs: the amount of unchanged bytes,
+ *      the amount of changed bytes and the changed bytes, until the frame is covered.
+ *      Single unchanged bytes stay inside a run of changed bytes, as a run would cost more than them.
+ *      An unchanged frame is written in 3 bytes.
+ *
+ *  @param video    The bit packed screen.
+ ***/
+void FrameRecorder::WriteDelta(const uint64_t *video)
+{
+    uint8_t delta[FrameRecorderConstants::FRAME_BYTES];
+    size_t position = 0;
+
+    for (size_t i = 0; i < FrameRecorderConstants::FRAME_BYTES; i++)
+    {
+        delta[i] = FrameByte(video, i) ^ FrameByte(this->previous, i);
+    }
+
+    this->encoded.clear();
+
+    while (position < FrameRecorderConstants::FRAME_BYTES)
+    {
+        size_t unchanged = 0;
+        size_t changed = 0;
+
+        while (position + unchanged < FrameRecorderConstants::FRAME_BYTES && delta[position + unchanged] == 0)
+        {
+            unchanged++;
+        }
+
+        position += unchanged;
+
+        //  The changed run ends at two unchanged bytes in a row.
+        while (position + changed < FrameRecorderConstants::FRAME_BYTES &&
+               (delta[position + changed] != 0 ||
+                (position + changed + 1 < FrameRecorderConstants::FRAME_BYTES && delta[position + changed + 1] != 0)))
+        {
+            changed++;
+        }
+
+        AppendVarint(this->encoded, unchanged);
+        AppendVarint(this->encoded, changed);
+        this->encoded.insert(this->encoded.end(), delta + position, delta + position + changed);
+        position += changed;
+    }
+
+    this->file.write(reinterpret_cast<const char *>(this->encoded.data()), this->encoded.size());
+    memcpy(this->previous, video, sizeof(this->previous));
+}
+
+/***
+ *  LoadDelta:
+ *      Reads a file written in the delta format, applying each frame to the one before it.
+ *
+ *  @param file_path    The file to read.
+ *
+ *  @return             The screens in the order they were written, their rows changed from the previous screen marked.
+ ***/
+std::vector<VideoFrame> FrameRecorder::LoadDelta(const char *file_path)
+{
+    std::ifstream file(file_path, std::ios::binary);
+    char magic[sizeof(FrameRecorderConstants::MAGIC)];
+    std::vector<VideoFrame> frames;
+    uint64_t video[Chip8Constants::VIDEO_HEIGHT]{};
+
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Could not open the frame recording.");
+    }
+
+    file.read(magic, sizeof(magic));
+
+    if (!file.good() || memcmp(magic, FrameRecorderConstants::MAGIC, sizeof(magic)) != 0 ||
+        file.get() != FrameRecorderConstants::VERSION ||
+        file.get() != Chip8Constants::VIDEO_WIDTH || file.get() != Chip8Constants::VIDEO_HEIGHT)
+    {
+        throw std::runtime_error("The file is not a frame recording of a supported version.");
+    }
+
+    while (file.peek() != std::ifstream::traits_type::eof())
+    {
+        VideoFrame frame{};
+        size_t position = 0;
+
+        while (position < FrameRecorderConstants::FRAME_BYTES)
+        {
+            position += ReadVarint(file);
+            size_t changed = ReadVarint(file);
+
+            if (!file.good() || position + changed > FrameRecorderConstants::FRAME_BYTES)
+            {
+                throw std::runtime_error("The frame recording is truncated.");
+            }
+
+            for (size_t end = position + changed; position < end; position++)
+            {
+                size_t row = position / sizeof(uint64_t);
+
+                video[row] ^= uint64_t(static_cast<uint8_t>(file.get())) << (56 - 8 * (position % sizeof(uint64_t)));
+                frame.dirtyRows |= 1u << row;
+            }
+        }
+
+        if (!file.good())
+        {
+            throw std::runtime_error("The frame recording is truncated.");
+        }
+
+        memcpy(frame.video, video, sizeof(frame.video));
+        frames.push_back(frame);
+    }
+
+    return frames;
+}
@@ -0,0 +1,81 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "Chip8.h"
+#include "FrameBuffer.h"
+#include "SPSCQueue.h"
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace FrameRecorderConstants
+{
+    //  The frames held between the emulation and the encoder thread, about a second of frames.
+    constexpr size_t CAPACITY = 64;
+
+    //  The delta file starts with the magic and the format version, then the screen size.
+    constexpr char MAGIC[4] = {'C', '8', 'F', 'D'};
+    constexpr uint8_t VERSION = 1;
+
+    //  The bytes of a bit packed screen, each row stored from its leftmost pixel.
+    constexpr size_t FRAME_BYTES = Chip8Constants::VIDEO_HEIGHT * sizeof(uint64_t);
+
+    //  The frame rate written to Y4M streams, a frame being recorded per 60 Hz timer frame.
+    constexpr uint32_t FRAMES_PER_SECOND = 60;
+};
+
+enum class FrameFormat
+{
+    //  Raw 8 bit monochrome YUV4MPEG2, for piping into external encoders.
+    Y4M,
+
+    //  Each frame XORed with the previous one, stored as runs of unchanged bytes and of changed bytes.
+    Delta
+};
+
+//  Streams screens to a file. The emulation thread only copies each screen into a bounded queue,
+//  a background thread encodes and writes them, so the emulation never waits for the disk.
+//  Screens pushed while the queue is full are dropped and counted.
+class FrameRecorder
+{
+private:
+    SPSCQueue<VideoFrame, FrameRecorderConstants::CAPACITY> frames;
+    std::ofstream file;
+    FrameFormat format;
+
+    //  Owned by the encoder thread: the last screen written, which the next delta is taken against.
+    uint64_t previous[Chip8Constants::VIDEO_HEIGHT]{};
+    std::vector<uint8_t> encoded;
+
+    //  Owned by the emulation thread.
+    size_t dropped{};
+
+    std::atomic<bool> stopping{false};
+    std::thread encoder;
+
+    //  Writes the queued screens until stopped, and then the screens left in the queue.
+    void EncoderLoop();
+    void WriteY4M(const uint64_t *video);
+    void WriteDelta(const uint64_t *video);
+
+public:
+    //  Opens the file and writes its header, throwing when it cannot be opened.
+    FrameRecorder(const char *file_path, FrameFormat format);
+
+    //  Writes every queued screen before closing the file.
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder &) = delete;
+    FrameRecorder &operator=(const FrameRecorder &) = delete;
+
+    //  Called by the emulation thread, returns false and drops the screen when the queue is full.
+    bool Push(const uint64_t *video, uint64_t cycles);
+
+    size_t Dropped() const { return this->dropped; }
+
+    //  Reads the screens of a delta file, throwing when it is not one.
+    static std::vector<VideoFrame> LoadDelta(const char *file_path);
+};
@@ -0,0 +1,280 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "Chip8.h"
+#include "FrameHash.h"
+#include "InputLog.h"
+#include "ROMCache.h"
+#include "ThreadPool.h"
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//  A ROM of the manifest, played with an input log, and the screen hash of each of its frames.
+struct GoldenJob
+{
+    std::string romPath;
+
+    //  The input log, "-" for a run without input, seeded with 0 at the default frame length.
+    std::string logPath;
+    uint64_t frames{};
+
+    //  The hashes stored in the manifest, empty for a ROM added by this run, and the hashes of this run.
+    std::vector<uint64_t> golden;
+    std::vector<uint64_t> hashes;
+    std::string error;
+};
+
+void LoadManifest(const char *file_path, std::vector<GoldenJob> &jobs);
+void SaveManifest(const char *file_path, const std::vector<GoldenJob> &jobs);
+void RunJob(GoldenJob &job, Chip8Engine engine);
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <Manifest> [--add <ROM> <InputLog or -> <Frames>]... [--update] [--threads <Threads>] [--engine interpreter|threaded|jit|aot]\n", argv[0]);
+        abort();
+    }
+
+    const char *manifestPath = argv[1];
+    size_t threads = 0;
+    bool update = false;
+    bool added = false;
+    Chip8Engine engine = Chip8Engine::Threaded;
+    std::vector<GoldenJob> jobs;
+
+    LoadManifest(manifestPath, jobs);
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--add") && i + 3 < argc)
+        {
+            GoldenJob job;
+            job.romPath = argv[i + 1];
+            job.logPath = argv[i + 2];
+            job.frames = std::stoull(argv[i + 3]);
+            jobs.push_back(job);
+            added = true;
+            i += 3;
+        }
+        else if (!strcmp(argv[i], "--update"))
+        {
+            update = true;
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+        {
+            threads = std::stoul(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--engine") && i + 1 < argc)
+        {
+            std::string name = argv[++i];
+            engine = (name == "jit") ? Chip8Engine::JIT : (name == "aot") ? Chip8Engine::AOT : (name == "interpreter") ? Chip8Engine::Interpreter : Chip8Engine::Threaded;
+        }
+        else
+        {
+            printf("Unknown option %s\n", argv[i]);
+            abort();
+        }
+    }
+
+    {
+        ThreadPool pool(threads);
+
+        for (GoldenJob &job : jobs)
+        {
+            pool.Submit([&job, engine]
+                        { RunJob(job, engine); });
+        }
+
+        pool.Wait();
+    }
+
+    //  Reporting in the order of the manifest, no matter which worker ran them.
+    //  Jobs which could not run fail even when updating, as there are no screens to accept.
+    size_t failed = 0;
+    size_t errors = 0;
+
+    printf("%-40s %10s  %s\n", "ROM", "Frames", "Result");
+
+    for (GoldenJob &job : jobs)
+    {
+        if (!job.error.empty())
+        {
+            printf("%-40s %10llu  %s\n", job.romPath.c_str(), (unsigned long long)job.frames, job.error.c_str());
+            failed++;
+            errors++;
+            continue;
+        }
+
+        if (job.golden.empty())
+        {
+            printf("%-40s %10llu  recorded\n", job.romPath.c_str(), (unsigned long long)job.frames);
+        }
+        else
+        {
+            //  The first frame whose hash differs, the screen being the same on every frame before it.
+            size_t frame = 0;
+
+            while (frame < job.hashes.size() && frame < job.golden.size() && job.hashes[frame] == job.golden[frame])
+            {
+                frame++;
+            }
+
+            if (frame == job.hashes.size() && frame == job.golden.size())
+            {
+                printf("%-40s %10llu  match\n", job.romPath.c_str(), (unsigned long long)job.frames);
+            }
+            else if (frame == job.golden.size() || frame == job.hashes.size())
+            {
+                printf("%-40s %10llu  the manifest holds %zu frames\n", job.romPath.c_str(), (unsigned long long)job.frames, job.golden.size());
+                failed++;
+            }
+            else
+            {
+                printf("%-40s %10llu  diverges at frame %zu: %016llx, expected %016llx\n",
+                       job.romPath.c_str(),
+                       (unsigned long long)job.frames,
+                       frame,
+                       (unsigned long long)job.hashes[frame],
+                       (unsigned long long)job.golden[frame]);
+                failed++;
+            }
+        }
+
+        if (update || job.golden.empty())
+        {
+            job.golden = job.hashes;
+        }
+    }
+
+    if (update || added)
+    {
+        SaveManifest(manifestPath, jobs);
+    }
+
+    printf("%zu ROMs, %zu failed\n", jobs.size(), failed);
+
+    //  An updated manifest accepts the screens of this run.
+    return ((failed == 0 || update) && errors == 0) ? 0 : 1;
+}
+
+/***
+ *  LoadManifest:
+ *      Reads a job from each line: the ROM, the input log and the amount of frames, followed by the hash of each frame.
+ *      Empty lines and lines starting with '#' are skipped, a missing manifest holds no jobs.
+ *
+ *  @param file_path    The manifest.
+ *  @param jobs         The jobs to add to.
+ ***/
+void LoadManifest(const char *file_path, std::vector<GoldenJob> &jobs)
+{
+    std::ifstream file(file_path);
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        std::istringstream fields(line);
+        std::string hash;
+        GoldenJob job;
+
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        if (!(fields >> job.romPath >> job.logPath >> job.frames))
+        {
+            throw std::runtime_error("A line of the golden manifest is missing its ROM, input log or frames.");
+        }
+
+        while (fields >> hash)
+        {
+            job.golden.push_back(std::stoull(hash, nullptr, 16));
+        }
+
+        jobs.push_back(job);
+    }
+}
+
+/***
+ *  SaveManifest:
+ *      Writes the jobs in the format `LoadManifest` reads, a line per ROM.
+ *
+ *  @param file_path    The manifest.
+ *  @param jobs         The jobs, with their golden hashes, added jobs which could not run are left out.
+ ***/
+void SaveManifest(const char *file_path, const std::vector<GoldenJob> &jobs)
+{
+    std::ofstream file(file_path, std::ios::trunc);
+    char hash[17];
+
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Could not open the golden manifest for writing.");
+    }
+
+    file << "# ROM InputLog Frames FrameHashes...\n";
+
+    for (const GoldenJob &job : jobs)
+    {
+        if (!job.error.empty() && job.golden.empty())
+        {
+            continue;
+        }
+
+        file << job.romPath << ' ' << job.logPath << ' ' << job.frames;
+
+        for (uint64_t golden : job.golden)
+        {
+            snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)golden);
+            file << ' ' << hash;
+        }
+
+        file << '\n';
+    }
+}
+
+/***
+ *  RunJob:
+ *      Replays the input log on the ROM a frame at a time, hashing the screen at the end of each frame.
+ *
+ *  @param job      The job, holding the ROM, the input log and the amount of frames, and receiving the hashes.
+ *  @param engine   The engine executing the ROM.
+ ***/
+void RunJob(GoldenJob &job, Chip8Engine engine)
+{
+    try
+    {
+        //  A `Chip8` runs a missing file as empty memory, whose blank screens would be taken as golden.
+        if (ROMCache::Instance().Load(job.romPath.c_str()) == nullptr)
+        {
+            throw std::runtime_error("Could not open the ROM.");
+        }
+
+        std::unique_ptr<Chip8> chip8(new Chip8(job.romPath.c_str(), engine));
+        InputLog log;
+
+        if (job.logPath != "-")
+        {
+            log.Load(job.logPath.c_str());
+        }
+
+        log.Start(*chip8);
+
+        for (uint64_t frame = 1; frame <= job.frames; frame++)
+        {
+            log.ReplayTo(*chip8, frame * log.instructionsPerFrame);
+            job.hashes.push_back(HashFrame(chip8->video));
+        }
+    }
+    catch (const std::exception &exception)
+    {
+        job.error = exception.what();
+    }
+}
@@ -0,0 +1,182 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "InputLog.h"
+#include "Varint.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+//  Little endian integers, so logs move between machines.
+static void WriteInteger(std::ofstream &file, uint64_t value, size_t bytes);
+static uint64_t ReadInteger(std::ifstream &file, size_t bytes);
+
+/***
+ *  Record:
+ *      Appends a change of the keypad, keypads equal to the last recorded one are dropped.
+ *
+ *  @param cycle    The cycle of the instruction the keypad applies to.
+ *  @param keys     The keypad mask.
+ ***/
+void InputLog::Record(uint64_t cycle, uint16_t keys)
+{
+    if (keys == this->lastKeys)
+    {
+        return;
+    }
+
+    this->changes.push_back({cycle, keys});
+    this->lastKeys = keys;
+}
+
+/***
+ *  Save:
+ *      Writes the header, then every change as the cycles since the previous change in a varint,
+ *      followed by the 16 bit keypad mask.
+ *
+ *  @param file_path The file to write.
+ ***/
+void InputLog::Save(const char *file_path) const
+{
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Could not open the input log for writing.");
+    }
+
+    file.write(InputLogConstants::MAGIC, sizeof(InputLogConstants::MAGIC));
+    WriteInteger(file, InputLogConstants::VERSION, 1);
+    WriteInteger(file, this->seed, 8);
+    WriteInteger(file, this->instructionsPerFrame, 4);
+    WriteInteger(file, this->endCycle, 8);
+    WriteVarint(file, this->changes.size());
+
+    uint64_t previous = 0;
+
+    for (const Change &change : this->changes)
+    {
+        WriteVarint(file, change.cycle - previous);
+        WriteInteger(file, change.keys, 2);
+        previous = change.cycle;
+    }
+
+    if (!file.good())
+    {
+        throw std::runtime_error("Could not write the input log.");
+    }
+}
+
+/***
+ *  Load:
+ *      Reads a log written by `Save`, replacing the recorded session.
+ *
+ *  @param file_path The file to read.
+ ***/
+void InputLog::Load(const char *file_path)
+{
+    std::ifstream file(file_path, std::ios::binary);
+    char magic[sizeof(InputLogConstants::MAGIC)];
+
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Could not open the input log.");
+    }
+
+    file.read(magic, sizeof(magic));
+
+    if (!file.good() || memcmp(magic, InputLogConstants::MAGIC, sizeof(magic)) != 0 || ReadInteger(file, 1) != InputLogConstants::VERSION)
+    {
+        throw std::runtime_error("The file is not an input log of a supported version.");
+    }
+
+    this->seed = ReadInteger(file, 8);
+    this->instructionsPerFrame = ReadInteger(file, 4);
+    this->endCycle = ReadInteger(file, 8);
+
+    uint64_t count = ReadVarint(file);
+    uint64_t cycle = 0;
+
+    this->changes.clear();
+    this->lastKeys = 0;
+
+    for (uint64_t i = 0; i < count && file.good(); i++)
+    {
+        cycle += ReadVarint(file);
+        this->Record(cycle, ReadInteger(file, 2));
+    }
+
+    if (!file.good())
+    {
+        throw std::runtime_error("The input log is truncated.");
+    }
+}
+
+/***
+ *  Replay:
+ *      Replays the whole session, applying each keypad at the cycle it was recorded at.
+ *
+ *  @param chip A machine constructed from the recorded ROM, which did not run yet.
+ ***/
+void InputLog::Replay(Chip8 &chip) const
+{
+    this->Start(chip);
+    this->ReplayTo(chip, this->endCycle);
+}
+
+/***
+ *  Start:
+ *      Seeds the machine, and sets the frame length and the keypad the session started with.
+ *
+ *  @param chip A machine constructed from the recorded ROM, which did not run yet.
+ ***/
+void InputLog::Start(Chip8 &chip) const
+{
+    chip.Seed(this->seed);
+    chip.SetInstructionsPerFrame(this->instructionsPerFrame);
+    chip.SetKeypadMask(0);
+}
+
+/***
+ *  ReplayTo:
+ *      Runs the machine from one change to the next, applying each keypad at the cycle it was
+ *      recorded at. A change at the given cycle itself is applied by the next call.
+ *
+ *  @param chip     A started machine, which only ran through this function.
+ *  @param cycle    The cycle to stop at.
+ ***/
+void InputLog::ReplayTo(Chip8 &chip, uint64_t cycle) const
+{
+    //  Finding the first change not applied yet, the changes are ordered by cycle.
+    auto change = std::lower_bound(this->changes.begin(), this->changes.end(), chip.Cycles(),
+                                   [](const Change &change, uint64_t cycle)
+                                   { return change.cycle < cycle; });
+
+    for (; change != this->changes.end() && change->cycle < cycle; ++change)
+    {
+        chip.Run(change->cycle - chip.Cycles());
+        chip.SetKeypadMask(change->keys);
+    }
+
+    chip.Run(cycle - chip.Cycles());
+}
+
+static void WriteInteger(std::ofstream &file, uint64_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++)
+    {
+        file.put(static_cast<char>((value >> (8 * i)) & 0xFFu));
+    }
+}
+
+static uint64_t ReadInteger(std::ifstream &file, size_t bytes)
+{
+    uint64_t value = 0;
+
+    for (size_t i = 0; i < bytes; i++)
+    {
+        value |= uint64_t(static_cast<uint8_t>(file.get())) << (8 * i);
+    }
+
+    return value;
+}
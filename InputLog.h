@@ -0,0 +1,55 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "Chip8.h"
+#include <vector>
+
+namespace InputLogConstants
+{
+    //  The file starts with the magic and the format version.
+    constexpr char MAGIC[4] = {'C', '8', 'I', 'L'};
+    constexpr uint8_t VERSION = 1;
+};
+
+//  A recorded session: the seed, the frame length and the keypad changes keyed by cycle.
+//  Replaying it on the same ROM reproduces the session exactly.
+class InputLog
+{
+private:
+    //  The keypad mask applied before the instruction at the given cycle.
+    struct Change
+    {
+        uint64_t cycle;
+        uint16_t keys;
+    };
+
+    std::vector<Change> changes;
+    uint16_t lastKeys{};
+
+public:
+    uint64_t seed{};
+    uint32_t instructionsPerFrame{Chip8Constants::DEFAULT_INSTRUCTIONS_PER_FRAME};
+
+    //  The cycle the session ended at.
+    uint64_t endCycle{};
+
+    //  Records the keypad mask before the instruction at the given cycle, only if it changed.
+    void Record(uint64_t cycle, uint16_t keys);
+
+    //  Writes and reads the log as a compact binary file, throwing on failure.
+    void Save(const char *file_path) const;
+    void Load(const char *file_path);
+
+    //  Re-executes the session on a machine freshly constructed from the recorded ROM.
+    void Replay(Chip8 &chip) const;
+
+    //  Seeds a machine freshly constructed from the recorded ROM, so it can be replayed in steps.
+    void Start(Chip8 &chip) const;
+
+    //  Runs a started machine up to the given cycle, applying the changes recorded before it.
+    void ReplayTo(Chip8 &chip, uint64_t cycle) const;
+
+    size_t Changes() const { return this->changes.size(); }
+};
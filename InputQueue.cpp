@@ -0,0 +1,44 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "InputQueue.h"
+#include <chrono>
+
+uint64_t InputQueue::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/***
+ *  Apply:
+ *      Removes the events captured up to the given time in their order, and applies them to the keypad.
+ *      Later events stay queued for the instruction running at their time, and so does an event undoing
+ *      a change already applied, as a press released before the next call would never reach the keypad.
+ *
+ *  @param keys The keypad mask before the events, bit `i` stands for key `i`.
+ *  @param time The host time of the instruction about to run.
+ *
+ *  @return     The keypad mask after the events.
+ ***/
+uint16_t InputQueue::Apply(uint16_t keys, uint64_t time)
+{
+    //  The keys this call already pressed or released.
+    uint16_t changed = 0;
+
+    for (const InputEvent *event = this->events.Front(); event != nullptr && event->time <= time; event = this->events.Front())
+    {
+        uint16_t key = 1u << event->key;
+        uint16_t next = event->pressed ? (keys | key) : (keys & ~key);
+
+        if ((changed & key) && next != keys)
+        {
+            break;
+        }
+
+        changed |= keys ^ next;
+        keys = next;
+        this->events.Pop();
+    }
+
+    return keys;
+}
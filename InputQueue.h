@@ -0,0 +1,44 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "SPSCQueue.h"
+#include <cstdint>
+
+namespace InputQueueConstants
+{
+    //  The amount of events held, a power of two so positions wrap with a mask.
+    constexpr size_t CAPACITY = 256;
+};
+
+//  A key pressed or released, and the host time it was captured at.
+struct InputEvent
+{
+    //  Nanoseconds of the host steady clock.
+    uint64_t time;
+    uint8_t key;
+    bool pressed;
+};
+
+//  A lock-free queue of input events from a single producer, the thread reading the host input,
+//  to a single consumer, the emulation thread, which applies them to the keypad between instructions.
+class InputQueue
+{
+private:
+    SPSCQueue<InputEvent, InputQueueConstants::CAPACITY> events;
+
+public:
+    //  Returns the current host time, in the unit events are stamped with.
+    static uint64_t Now();
+
+    //  Called by the producer, returns false and drops the event when the queue is full.
+    bool Push(const InputEvent &event) { return this->events.Push(event); }
+
+    //  Called by the consumer, applies the events captured up to the given time to a keypad mask.
+    //  An event undoing a change of the same call stays queued, so no press is lost between two calls.
+    uint16_t Apply(uint16_t keys, uint64_t time);
+
+    //  Called by the consumer, true while events are queued.
+    bool Pending() { return this->events.Front() != nullptr; }
+};
@@ -1,4 +1,5 @@
 #include "PlatformInterface.h"
+#include <cstring>
 
 /***
  *  PlatformInterface:
@@ -8,7 +9,8 @@ PlatformInterface::PlatformInterface(const char *title,
                    size_t windowWidth,
                    size_t windowHeight,
                    size_t textureWidth,
-                   size_t textureHeight)
+                   size_t textureHeight) : textureWidth(textureWidth),
+                                           textureHeight(textureHeight)
 {
     //  Initiates SDL.
     SDL_Init(SDL_INIT_VIDEO);
@@ -21,6 +23,15 @@ PlatformInterface::PlatformInterface(const char *title,
                                     windowHeight,
                                     SDL_WINDOW_SHOWN);
 
+    this->CreateRenderer();
+}
+
+/***
+ *  CreateRenderer:
+ *      Creates the renderer of the window, and the texture the screen is stretched out of.
+ ***/
+void PlatformInterface::CreateRenderer()
+{
     //  Creates a renderer out of the window.
     this->renderer = SDL_CreateRenderer(this->window,
                                         -1,
@@ -30,19 +41,61 @@ PlatformInterface::PlatformInterface(const char *title,
     this->texture = SDL_CreateTexture(this->renderer,
                                       SDL_PIXELFORMAT_RGBA8888,
                                       SDL_TEXTUREACCESS_STREAMING,
-                                      textureWidth,
-                                      textureHeight);
+                                      this->textureWidth,
+                                      this->textureHeight);
+}
+
+/***
+ *  UseSoftwareRenderer:
+ *      Destroys the renderer, as a window with a renderer has no surface to write, and starts
+ *      rendering every frame on the CPU straight into the window surface.
+ *
+ *  @param scale        The window pixels per screen pixel, in each direction.
+ *  @param filter       The scaling filter.
+ *  @param persistence  How much of its brightness a pixel turned off keeps each frame, out of 256.
+ *
+ *  @return             False if the window surface cannot be written, the renderer is then created again.
+ ***/
+bool PlatformInterface::UseSoftwareRenderer(uint32_t scale, ScaleFilter filter, uint8_t persistence)
+{
+    SDL_DestroyTexture(this->texture);
+    SDL_DestroyRenderer(this->renderer);
+    this->texture = nullptr;
+    this->renderer = nullptr;
+
+    SDL_Surface *surface = SDL_GetWindowSurface(this->window);
+
+    if (surface == nullptr || surface->format->BytesPerPixel != sizeof(uint32_t))
+    {
+        printf("Could not render on the CPU, using the renderer: %s\n", SDL_GetError());
+        this->CreateRenderer();
+
+        return false;
+    }
+
+    this->upscaler = std::make_unique<Upscaler>(scale, filter, persistence);
+
+    return true;
 }
 
 /***
  *  ~PlatformInterface:
- *      Destructor, destroys texture, then the renderer and finally the window sequentially.
+ *      Destructor, closes the audio device, destroys texture, then the renderer and finally the window sequentially.
  *      In reversed order than how they were made. Finally it quits SDL.
  ***/
 PlatformInterface::~PlatformInterface()
 {
-    SDL_DestroyTexture(this->texture);
-    SDL_DestroyRenderer(this->renderer);
+    if (this->audioDevice != 0)
+    {
+        SDL_CloseAudioDevice(this->audioDevice);
+    }
+
+    if (this->renderer != nullptr)
+    {
+        SDL_DestroyTexture(this->texture);
+        SDL_DestroyRenderer(this->renderer);
+    }
+
     SDL_DestroyWindow(this->window);
     SDL_Quit();
 }
@@ -50,18 +103,49 @@ PlatformInterface::~PlatformInterface()
 /***
  *  Update:
  *      Updates the graphics of the window shown to the
- *      user accourding to the buffer and the pitch given.
+ *      user accourding to the newest frame the emulation published,
+ *      writing only the rows which changed since the last presented frame.
+ *      Nothing is presented when no new frame was published or no row changed.
+ *      With the CPU renderer the frame is rendered by `UpdateSurface` instead.
+ *
+ *  @param frames   The frames published by the emulation thread.
  *
- *  @param buffer   The matrix buffer with the boolean values indicating which pixel is on or off.
- *  @param pitch    The number of bytes in a row of pixel data, including padding between lines.
+ *  @return         Whether a new frame was taken.
 */
-void PlatformInterface::Update(void const *buffer, int pitch)
+bool PlatformInterface::Update(FrameBuffer &frames)
 {
-    //  Update the texture accourding the new buffer.
-    SDL_UpdateTexture(this->texture,
-                      nullptr,
-                      buffer,
-                      pitch);
+    const VideoFrame *frame = frames.Acquire();
+
+    if (this->upscaler != nullptr)
+    {
+        return this->UpdateSurface(frame);
+    }
+
+    if (frame == nullptr)
+    {
+        return false;
+    }
+
+    uint32_t dirtyRows = frame->dirtyRows;
+
+    if (dirtyRows == 0)
+    {
+        return true;
+    }
+
+    //  Only the span between the first and the last changed rows is written.
+    int firstRow = __builtin_ctz(dirtyRows);
+    int lastRow = 31 - __builtin_clz(dirtyRows);
+    SDL_Rect span = {0, firstRow, Chip8Constants::VIDEO_WIDTH, lastRow - firstRow + 1};
+    void *pixels;
+    int pitch;
+
+    //  Expanding the rows straight into the texture memory.
+    if (SDL_LockTexture(this->texture, &span, &pixels, &pitch) == 0)
+    {
+        Chip8::ExpandRows(frame->video, static_cast<uint32_t *>(pixels), pitch, span.y, span.h);
+        SDL_UnlockTexture(this->texture);
+    }
 
     //  Clearing the old renderer.
     SDL_RenderClear(this->renderer);
@@ -74,249 +158,171 @@ void PlatformInterface::Update(void const *buffer, int pitch)
 
     //  Update the Renderer.
     SDL_RenderPresent(this->renderer);
+
+    return true;
 }
 
 /***
- *  ProcessInput:
- *      This function will communicate with the machine this program runs in,
- *      and will update the keys buffer for a matching key being pressed.
+ *  UpdateSurface:
+ *      Renders the whole screen into the window surface on the CPU, each frame costing the same.
+ *      Without a new frame the last screen is rendered again at the display rate while lit pixels fade.
  *
- *  @param keys A key buffer of boolean values indicating which keys are being pressed.
+ *  @param frame    The newest frame, or `nullptr` when none was published since the last call.
  *
- *  @return     This function will return true if the user pressed Escape key to quit the program.
+ *  @return         Whether a new frame was taken.
  ***/
-bool PlatformInterface::ProcessInput(uint8_t *keys)
+bool PlatformInterface::UpdateSurface(const VideoFrame *frame)
 {
-    bool quit = false;
-    SDL_Event event;
+    uint32_t now = SDL_GetTicks();
 
-    //  Will itterate over the events, all while there is a pending event.
-    while (SDL_PollEvent(&event))
+    if (frame != nullptr)
     {
-        switch (event.type)
-        {
-        //  Will quit if the event type is quit.
-        case SDL_QUIT:
-        {
-            quit = true;
-        }
-        break;
-
-        //  In the event of a key being pressed, it raises the bit of the matching index in the given buffer.
-        case SDL_KEYDOWN:
-        {
-            switch (event.key.keysym.sym)
-            {
-            case SDLK_ESCAPE:
-            {
-                quit = true;
-            }
-            break;
-
-            case SDLK_x:
-            {
-                keys[0] = 1;
-            }
-            break;
-
-            case SDLK_1:
-            {
-                keys[1] = 1;
-            }
-            break;
-
-            case SDLK_2:
-            {
-                keys[2] = 1;
-            }
-            break;
-
-            case SDLK_3:
-            {
-                keys[3] = 1;
-            }
-            break;
+        memcpy(this->lastVideo, frame->video, sizeof(this->lastVideo));
+    }
+    else if (!this->upscaler->Fading() || now - this->lastRender < PlatformInterfaceConstants::FADE_FRAME_MS)
+    {
+        return false;
+    }
 
-            case SDLK_q:
-            {
-                keys[4] = 1;
-            }
-            break;
+    //  The surface is taken again every frame, as resizing the window replaces it.
+    SDL_Surface *surface = SDL_GetWindowSurface(this->window);
 
-            case SDLK_w:
-            {
-                keys[5] = 1;
-            }
-            break;
+    if (surface == nullptr ||
+        size_t(surface->w) < this->upscaler->OutputWidth() ||
+        size_t(surface->h) < this->upscaler->OutputHeight() ||
+        (SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) != 0))
+    {
+        return frame != nullptr;
+    }
 
-            case SDLK_e:
-            {
-                keys[6] = 1;
-            }
-            break;
+    this->upscaler->Render(this->lastVideo, static_cast<uint32_t *>(surface->pixels), surface->pitch);
 
-            case SDLK_a:
-            {
-                keys[7] = 1;
-            }
-            break;
+    if (SDL_MUSTLOCK(surface))
+    {
+        SDL_UnlockSurface(surface);
+    }
 
-            case SDLK_s:
-            {
-                keys[8] = 1;
-            }
-            break;
+    SDL_UpdateWindowSurface(this->window);
+    this->lastRender = now;
 
-            case SDLK_d:
-            {
-                keys[9] = 1;
-            }
-            break;
-
-            case SDLK_z:
-            {
-                keys[0xA] = 1;
-            }
-            break;
+    return frame != nullptr;
+}
 
-            case SDLK_c:
-            {
-                keys[0xB] = 1;
-            }
-            break;
+/***
+ *  PushInputs:
+ *      Pushes the events not queued yet, stopping at the first one the full queue drops, so a release
+ *      is never lost and the keys keep their order.
+ *
+ *  @param inputs   The queue the emulation thread applies the keys out of.
+ ***/
+void PlatformInterface::PushInputs(InputQueue &inputs)
+{
+    while (!this->unsentInputs.empty() && inputs.Push(this->unsentInputs.front()))
+    {
+        this->unsentInputs.pop_front();
+    }
+}
 
-            case SDLK_4:
-            {
-                keys[0xC] = 1;
-            }
-            break;
+/***
+ *  ProcessInput:
+ *      This function will communicate with the machine this program runs in,
+ *      and will queue the keys being pressed and released with the time they were seen at.
+ *      It waits for the first event up to the timeout, so an idle loop calling it does not spin.
+ *
+ *  @param inputs   The queue the emulation thread applies the keys out of.
+ *  @param timeout  The most milliseconds to wait for an event.
+ *
+ *  @return         This function will return true if the user pressed Escape key to quit the program.
+ ***/
+bool PlatformInterface::ProcessInput(InputQueue &inputs, int timeout)
+{
+    //  The host key of every `Chip8` key, in the order of the keys.
+    static const SDL_Keycode keymap[Chip8Constants::AMOUNT_OF_CHARS] = {
+        SDLK_x, SDLK_1, SDLK_2, SDLK_3,
+        SDLK_q, SDLK_w, SDLK_e, SDLK_a,
+        SDLK_s, SDLK_d, SDLK_z, SDLK_c,
+        SDLK_4, SDLK_r, SDLK_f, SDLK_v};
 
-            case SDLK_r:
-            {
-                keys[0xD] = 1;
-            }
-            break;
+    bool quit = false;
+    SDL_Event event;
 
-            case SDLK_f:
-            {
-                keys[0xE] = 1;
-            }
-            break;
+    //  The emulation thread made room since the last call.
+    this->PushInputs(inputs);
 
-            case SDLK_v:
-            {
-                keys[0xF] = 1;
-            }
-            break;
-            }
+    //  Will itterate over the events, all while there is a pending event.
+    for (bool pending = SDL_WaitEventTimeout(&event, timeout); pending; pending = SDL_PollEvent(&event))
+    {
+        //  Will quit if the event type is quit, or if Escape is pressed.
+        if (event.type == SDL_QUIT || (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE))
+        {
+            quit = true;
         }
-        break;
 
-        //  After the key released, it zeros the matching bit in the buffer.
-        case SDL_KEYUP:
+        //  Repeated presses of a held key change nothing.
+        if ((event.type != SDL_KEYDOWN && event.type != SDL_KEYUP) || event.key.repeat)
         {
-            switch (event.key.keysym.sym)
-            {
-            case SDLK_x:
-            {
-                keys[0] = 0;
-            }
-            break;
-
-            case SDLK_1:
-            {
-                keys[1] = 0;
-            }
-            break;
-
-            case SDLK_2:
-            {
-                keys[2] = 0;
-            }
-            break;
-
-            case SDLK_3:
-            {
-                keys[3] = 0;
-            }
-            break;
-
-            case SDLK_q:
-            {
-                keys[4] = 0;
-            }
-            break;
-
-            case SDLK_w:
-            {
-                keys[5] = 0;
-            }
-            break;
-
-            case SDLK_e:
-            {
-                keys[6] = 0;
-            }
-            break;
-
-            case SDLK_a:
-            {
-                keys[7] = 0;
-            }
-            break;
-
-            case SDLK_s:
-            {
-                keys[8] = 0;
-            }
-            break;
-
-            case SDLK_d:
-            {
-                keys[9] = 0;
-            }
-            break;
+            continue;
+        }
 
-            case SDLK_z:
+        for (uint8_t key = 0; key < Chip8Constants::AMOUNT_OF_CHARS; key++)
+        {
+            if (keymap[key] == event.key.keysym.sym)
             {
-                keys[0xA] = 0;
+                this->unsentInputs.push_back({InputQueue::Now(), key, event.type == SDL_KEYDOWN});
             }
-            break;
+        }
+    }
 
-            case SDLK_c:
-            {
-                keys[0xB] = 0;
-            }
-            break;
+    this->PushInputs(inputs);
 
-            case SDLK_4:
-            {
-                keys[0xC] = 0;
-            }
-            break;
+    return quit;
+}
 
-            case SDLK_r:
-            {
-                keys[0xD] = 0;
-            }
-            break;
+/***
+ *  OpenAudio:
+ *      Opens the audio device with mono 16 bit samples, and starts the beeper playing through it.
+ *      The driver is the one SDL picks, the `dummy` and `disk` drivers chosen through `SDL_AUDIODRIVER`
+ *      run the same callback without a sound card.
+ *
+ *  @param beeper           The beeper generating the samples, it must outlive the device.
+ *  @param bufferSamples    The amount of samples in a buffer, smaller buffers lower the latency.
+ *
+ *  @return                 False if the audio could not be opened, the emulation then runs silently.
+ ***/
+bool PlatformInterface::OpenAudio(Beeper &beeper, uint16_t bufferSamples)
+{
+    SDL_AudioSpec desired{};
+    SDL_AudioSpec obtained{};
+
+    desired.freq = BeeperConstants::SAMPLE_RATE;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = 1;
+    desired.samples = bufferSamples;
+    desired.callback = &PlatformInterface::AudioCallback;
+    desired.userdata = &beeper;
+
+    //  Without allowing changes SDL converts to whatever the device plays, so the callback always gets this format.
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0 ||
+        (this->audioDevice = SDL_OpenAudioDevice(nullptr, 0, &desired, &obtained, 0)) == 0)
+    {
+        printf("Could not open the audio, running silently: %s\n", SDL_GetError());
+        return false;
+    }
 
-            case SDLK_f:
-            {
-                keys[0xE] = 0;
-            }
-            break;
+    SDL_PauseAudioDevice(this->audioDevice, 0);
 
-            case SDLK_v:
-            {
-                keys[0xF] = 0;
-            }
-            break;
-            }
-        }
-        break;
-        }
-    }
+    return true;
+}
 
-    return quit;
+/***
+ *  AudioCallback:
+ *      Called by SDL on its audio thread whenever the device needs samples, takes no locks.
+ *
+ *  @param userdata The beeper the device was opened with.
+ *  @param stream   The buffer to fill.
+ *  @param length   The size of the buffer in bytes.
+ ***/
+void PlatformInterface::AudioCallback(void *userdata, Uint8 *stream, int length)
+{
+    static_cast<Beeper *>(userdata)->Fill(reinterpret_cast<int16_t *>(stream), length / sizeof(int16_t), InputQueue::Now());
 }
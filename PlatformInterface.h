@@ -1,5 +1,18 @@
 #include <SDL2/SDL.h>
+#include <deque>
 #include <iostream>
+#include <memory>
+#include "Beeper.h"
+#include "Chip8.h"
+#include "FrameBuffer.h"
+#include "InputQueue.h"
+#include "Upscaler.h"
+
+namespace PlatformInterfaceConstants
+{
+    //  The milliseconds between the frames rendered while lit pixels fade, the 60 Hz of the display.
+    constexpr uint32_t FADE_FRAME_MS = 16;
+};
 
 class PlatformInterface
 {
@@ -7,6 +20,25 @@ private:
     SDL_Window *window{};
     SDL_Renderer *renderer{};
     SDL_Texture *texture{};
+    SDL_AudioDeviceID audioDevice{};
+    size_t textureWidth;
+    size_t textureHeight;
+
+    //  The CPU render path: the window surface is written directly, out of the last screen taken.
+    std::unique_ptr<Upscaler> upscaler;
+    uint64_t lastVideo[Chip8Constants::VIDEO_HEIGHT]{};
+    uint32_t lastRender{};
+
+    //  The events which found the input queue full, pushed again in their order before any newer one.
+    std::deque<InputEvent> unsentInputs;
+
+    void PushInputs(InputQueue &inputs);
+
+    void CreateRenderer();
+    bool UpdateSurface(const VideoFrame *frame);
+
+    //  Fills the buffers of the audio device out of the `Beeper` it was opened with, on the audio thread.
+    static void AudioCallback(void *userdata, Uint8 *stream, int length);
 
 public:
     PlatformInterface(const char *title,
@@ -17,8 +49,14 @@ public:
 
     ~PlatformInterface();
 
-    void Update(void const *buffer,
-                int pitch);
+    bool Update(FrameBuffer &frames);
+
+    //  Renders on the CPU into the window surface instead of stretching a texture, for hosts without a GPU.
+    //  Returns false, keeping the renderer, if the surface is not 32 bits per pixel.
+    bool UseSoftwareRenderer(uint32_t scale, ScaleFilter filter, uint8_t persistence);
+
+    bool ProcessInput(InputQueue &inputs, int timeout);
 
-    bool ProcessInput(uint8_t *keys);
+    //  Plays the tone of the beeper through buffers of the given amount of samples, false if no device opens.
+    bool OpenAudio(Beeper &beeper, uint16_t bufferSamples = BeeperConstants::DEFAULT_BUFFER_SAMPLES);
 };
@@ -0,0 +1,156 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "ROMCache.h"
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ROM_CACHE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define ROM_CACHE_MMAP 0
+#endif
+
+ROMCache &ROMCache::Instance()
+{
+    static ROMCache cache;
+
+    return cache;
+}
+
+/***
+ *  Load:
+ *      Looks the file up by its path, and reads it on the first request.
+ *      A newly read file which has the content of an image already cached shares that image.
+ *
+ *  @param file_path The ROM file.
+ *
+ *  @return          The image, or `nullptr` if the file can not be opened.
+ ***/
+std::shared_ptr<const ROMImage> ROMCache::Load(const char *file_path)
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    auto cached = this->byPath.find(file_path);
+
+    if (cached != this->byPath.end())
+    {
+        return cached->second;
+    }
+
+    std::shared_ptr<ROMImage> image(new ROMImage());
+
+    if (!ReadFile(file_path, *image))
+    {
+        return nullptr;
+    }
+
+    image->hash = Hash(image->bytes, image->size);
+
+    //  Two paths with the same content share one image, and the new copy is dropped.
+    auto same = this->byHash.find(image->hash);
+
+    if (same != this->byHash.end() && same->second->size == image->size && memcmp(same->second->bytes, image->bytes, image->size) == 0)
+    {
+        this->byPath[file_path] = same->second;
+        return same->second;
+    }
+
+    this->byHash[image->hash] = image;
+    this->byPath[file_path] = image;
+
+    return image;
+}
+
+void ROMCache::Clear()
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    this->byPath.clear();
+    this->byHash.clear();
+}
+
+uint64_t ROMCache::Hash(const uint8_t *bytes, size_t size)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+/***
+ *  ReadFile:
+ *      Maps the file read only and copies it, or reads it through a stream where mapping is not available.
+ *      The mapping is released right away, as a file truncated while it is mapped faults its readers.
+ *
+ *  @param file_path The file to read.
+ *  @param image     Receives the contents.
+ *
+ *  @return          `false` if the file can not be opened.
+ ***/
+bool ROMCache::ReadFile(const char *file_path, ROMImage &image)
+{
+#if ROM_CACHE_MMAP
+    int file = open(file_path, O_RDONLY);
+    struct stat status;
+
+    if (file < 0)
+    {
+        return false;
+    }
+
+    if (fstat(file, &status) != 0 || !S_ISREG(status.st_mode))
+    {
+        close(file);
+        return false;
+    }
+
+    //  An empty file can not be mapped, and has nothing to copy.
+    if (status.st_size > 0)
+    {
+        void *mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+        if (mapping == MAP_FAILED)
+        {
+            close(file);
+            return false;
+        }
+
+        const uint8_t *bytes = static_cast<const uint8_t *>(mapping);
+
+        image.buffer.assign(bytes, bytes + status.st_size);
+        munmap(mapping, status.st_size);
+    }
+
+    close(file);
+
+    image.bytes = image.buffer.data();
+    image.size = image.buffer.size();
+
+    return true;
+#else
+    std::ifstream code_file(file_path, std::ios::binary | std::ios::ate);
+
+    if (!code_file.is_open())
+    {
+        return false;
+    }
+
+    image.buffer.resize(code_file.tellg());
+    code_file.seekg(0, std::ios::beg);
+    code_file.read(reinterpret_cast<char *>(image.buffer.data()), image.buffer.size());
+
+    image.bytes = image.buffer.data();
+    image.size = image.buffer.size();
+
+    return true;
+#endif
+}
@@ -0,0 +1,58 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//  The contents of a ROM file, shared by every `Chip8` loading it.
+//  The bytes are owned by the image, so a file changed or truncated while cached can not fault a reader.
+class ROMImage
+{
+    friend class ROMCache;
+
+private:
+    std::vector<uint8_t> buffer;
+
+public:
+    uint64_t hash{};
+    const uint8_t *bytes{};
+    size_t size{};
+
+    ROMImage() = default;
+    ROMImage(const ROMImage &) = delete;
+    ROMImage &operator=(const ROMImage &) = delete;
+};
+
+//  A process wide cache of ROM files, each file is read once and each distinct content is stored once.
+class ROMCache
+{
+private:
+    std::mutex lock;
+
+    //  Files already read, by their path, and the images by their content hash.
+    std::unordered_map<std::string, std::shared_ptr<const ROMImage>> byPath;
+    std::unordered_map<uint64_t, std::shared_ptr<const ROMImage>> byHash;
+
+    ROMCache() = default;
+
+    //  Copies a whole file through a mapping, or a stream where mapping is not supported, `false` if it can not be opened.
+    static bool ReadFile(const char *file_path, ROMImage &image);
+
+public:
+    static ROMCache &Instance();
+
+    //  Returns the image of the file, reading it only the first time, `nullptr` if it can not be opened.
+    std::shared_ptr<const ROMImage> Load(const char *file_path);
+
+    //  Forgets every file, so changed files are read again.
+    void Clear();
+
+    //  Hashes the bytes with 64 bit FNV-1a.
+    static uint64_t Hash(const uint8_t *bytes, size_t size);
+};
@@ -0,0 +1,414 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "Recompiler.h"
+#include "ROMCache.h"
+#include <cstdarg>
+#include <set>
+#include <stdexcept>
+
+//  Writes a formatted line of the generated code.
+static void EmitLine(std::ostream &output, const char *format, ...)
+{
+    char line[256];
+    va_list arguments;
+
+    va_start(arguments, format);
+    vsnprintf(line, sizeof(line), format, arguments);
+    va_end(arguments);
+
+    output << line << '\n';
+}
+
+/***
+ *  Constructor:
+ *      Reads the ROM through the cache and recovers its control flow.
+ *
+ *  @param file_path The file of the ROM.
+ ***/
+Recompiler::Recompiler(const char *file_path) : name(file_path)
+{
+    std::shared_ptr<const ROMImage> image = ROMCache::Instance().Load(file_path);
+
+    if (image == nullptr)
+    {
+        throw std::runtime_error("Could not open the ROM to recompile.");
+    }
+
+    if (image->size > (Chip8Constants::RAM_SIZE_IN_BYTES - Chip8Constants::START_ADDRESS))
+    {
+        printf("Aborting, `ROM` file is bigger than allocated memory buffer.\n");
+        throw std::overflow_error("ROM is bigger than allocated memory buffer.");
+    }
+
+    this->rom.assign(image->bytes, image->bytes + image->size);
+    this->Recover();
+}
+
+bool Recompiler::InROM(uint32_t address) const
+{
+    return address >= Chip8Constants::START_ADDRESS && address + 2 <= Chip8Constants::START_ADDRESS + this->rom.size();
+}
+
+uint16_t Recompiler::Opcode(uint16_t address) const
+{
+    size_t offset = address - Chip8Constants::START_ADDRESS;
+
+    return (this->rom[offset] << 8u) | this->rom[offset + 1];
+}
+
+size_t Recompiler::InstructionCount() const
+{
+    size_t instructions = 0;
+
+    for (const auto &block : this->blocks)
+    {
+        instructions += block.second;
+    }
+
+    return instructions;
+}
+
+/***
+ *  Classify:
+ *      Decodes the opcode the way the operation tables of `Chip8` do, so every opcode executes
+ *      the operation it executes in the interpreter. Opcodes of unassigned slots do nothing.
+ *
+ *  @param opcode   The opcode.
+ *
+ *  @return         How the opcode continues the control flow, `Interpreted` if it is not recompiled.
+ ***/
+Recompiler::Flow Recompiler::Classify(uint16_t opcode)
+{
+    uint8_t n = opcode & 0x000Fu;
+    uint8_t kk = opcode & 0x00FFu;
+
+    switch (opcode >> 12u)
+    {
+    case 0x0:
+        return (n == 0x0) ? Flow::Interpreted : (n == 0xE) ? Flow::Return : Flow::Straight;
+    case 0x1:
+        return Flow::Jump;
+    case 0x2:
+        return Flow::Call;
+    case 0x3:
+    case 0x4:
+    case 0x5:
+    case 0x9:
+        return Flow::Skip;
+    case 0xB:
+    case 0xC:
+    case 0xD:
+        return Flow::Interpreted;
+    case 0xE:
+        return (n == 0x1 || n == 0xE) ? Flow::Skip : Flow::Straight;
+    case 0xF:
+        return (kk == 0x07 || kk == 0x0A || kk == 0x15 || kk == 0x18 || kk == 0x33 || kk == 0x55) ? Flow::Interpreted : Flow::Straight;
+    default:
+        return Flow::Straight;
+    }
+}
+
+/***
+ *  Recover:
+ *      Follows the control flow from the start address. A block ends at a jump, call, return or skip,
+ *      before an operation left to the interpreter, or at `MAX_BLOCK_INSTRUCTIONS`.
+ *      Every statically known target starts a block: the jump and call targets, the return address of a call,
+ *      both sides of a skip and the instruction after an interpreted one.
+ *      Targets outside the ROM and the targets of `Bnnn` are left to the interpreter.
+ ***/
+void Recompiler::Recover()
+{
+    std::vector<uint16_t> pending = {Chip8Constants::START_ADDRESS};
+    std::set<uint16_t> visited;
+
+    while (!pending.empty())
+    {
+        uint16_t start = pending.back();
+        uint16_t address = start;
+        uint16_t instructions = 0;
+        bool ended = false;
+
+        pending.pop_back();
+
+        if (!this->InROM(start) || !visited.insert(start).second)
+        {
+            continue;
+        }
+
+        while (!ended && instructions < Chip8AOTConstants::MAX_BLOCK_INSTRUCTIONS && this->InROM(address))
+        {
+            uint16_t opcode = this->Opcode(address);
+            uint16_t nnn = opcode & 0x0FFFu;
+
+            switch (Classify(opcode))
+            {
+            case Flow::Straight:
+                break;
+            case Flow::Jump:
+                pending.push_back(nnn);
+                ended = true;
+                break;
+            case Flow::Call:
+                pending.push_back(address + 2);
+                pending.push_back(nnn);
+                ended = true;
+                break;
+            case Flow::Return:
+                ended = true;
+                break;
+            case Flow::Skip:
+                pending.push_back(address + 4);
+                pending.push_back(address + 2);
+                ended = true;
+                break;
+            case Flow::Interpreted:
+                //  The interpreter continues after the operation, only a computed jump goes anywhere else.
+                if ((opcode >> 12u) != 0xB)
+                {
+                    pending.push_back(address + 2);
+                }
+
+                ended = true;
+                continue;
+            }
+
+            instructions++;
+            address += 2;
+        }
+
+        //  A block cut at its longest length or at the end of the ROM continues after its last instruction.
+        if (!ended)
+        {
+            pending.push_back(address);
+        }
+
+        if (instructions > 0)
+        {
+            this->blocks[start] = instructions;
+        }
+    }
+}
+
+void Recompiler::EmitHeader(std::ostream &output)
+{
+    EmitLine(output, "//  Generated by the recompiler out of the ROMs below, recompile them instead of editing it.");
+    EmitLine(output, "");
+    EmitLine(output, "#include <Chip8AOT.h>");
+}
+
+/***
+ *  Emit:
+ *      Writes the ROM bytes, a function per block and the table registering them.
+ *      The operations are written as the interpreter executes them, in the same order,
+ *      so the registers and flags end up the same even when `x` or `y` is `F`.
+ *
+ *  @param output   The stream of the generated file.
+ *  @param number   The number of the program in the file.
+ ***/
+void Recompiler::Emit(std::ostream &output, size_t number) const
+{
+    EmitLine(output, "");
+    EmitLine(output, "//  %s: %zu blocks, %zu instructions.", this->name.c_str(), this->BlockCount(), this->InstructionCount());
+    EmitLine(output, "namespace Recompiled%zu", number);
+    EmitLine(output, "{");
+    EmitLine(output, "    const uint8_t rom[] = {");
+
+    for (size_t offset = 0; offset < this->rom.size(); offset += 16)
+    {
+        std::string line = "       ";
+
+        for (size_t i = offset; i < offset + 16 && i < this->rom.size(); i++)
+        {
+            char byte[8];
+
+            snprintf(byte, sizeof(byte), " 0x%02X,", this->rom[i]);
+            line += byte;
+        }
+
+        EmitLine(output, "%s", line.c_str());
+    }
+
+    EmitLine(output, "    };");
+
+    for (const auto &block : this->blocks)
+    {
+        uint16_t address = block.first;
+
+        EmitLine(output, "");
+        EmitLine(output, "    static void Block_%04X(Chip8State &s)", block.first);
+        EmitLine(output, "    {");
+
+        for (uint16_t i = 0; i < block.second; i++, address += 2)
+        {
+            EmitInstruction(output, this->Opcode(address), address);
+        }
+
+        //  The block fell through to the instruction after it, the last one ending it sets the counter itself.
+        Flow last = Classify(this->Opcode(address - 2));
+
+        if (last == Flow::Straight)
+        {
+            EmitLine(output, "        s.pc = 0x%04X;", address);
+        }
+
+        EmitLine(output, "    }");
+    }
+
+    EmitLine(output, "");
+
+    if (this->blocks.empty())
+    {
+        EmitLine(output, "    const Chip8AOTProgram program = {\"%s\", rom, sizeof(rom), nullptr, 0};", this->name.c_str());
+    }
+    else
+    {
+        EmitLine(output, "    const Chip8AOTBlock blocks[] = {");
+
+        for (const auto &block : this->blocks)
+        {
+            EmitLine(output, "        {0x%04X, %u, &Block_%04X},", block.first, block.second, block.first);
+        }
+
+        EmitLine(output, "    };");
+        EmitLine(output, "");
+        EmitLine(output, "    const Chip8AOTProgram program = {\"%s\", rom, sizeof(rom), blocks, sizeof(blocks) / sizeof(blocks[0])};", this->name.c_str());
+    }
+
+    EmitLine(output, "");
+    EmitLine(output, "    const bool registered = Chip8AOT::Register(program);");
+    EmitLine(output, "}");
+}
+
+/***
+ *  EmitInstruction:
+ *      Writes the statements of a recompiled instruction, the Program Counter being the address after it
+ *      as the interpreter advances it before executing.
+ *
+ *  @param output   The stream of the generated file.
+ *  @param opcode   The opcode.
+ *  @param address  The address of the opcode.
+ ***/
+void Recompiler::EmitInstruction(std::ostream &output, uint16_t opcode, uint16_t address)
+{
+    uint16_t nnn = opcode & 0x0FFFu;
+    uint8_t x = (opcode & 0x0F00u) >> 8u;
+    uint8_t y = (opcode & 0x00F0u) >> 4u;
+    uint8_t kk = opcode & 0x00FFu;
+    uint8_t n = opcode & 0x000Fu;
+    uint16_t next = address + 2;
+    uint16_t skipped = address + 4;
+    const char *condition = nullptr;
+    char operands[128];
+
+    EmitLine(output, "        //  0x%04X: %04X", address, opcode);
+
+    switch (opcode >> 12u)
+    {
+    case 0x0:
+        if (n == 0xE)
+        {
+            EmitLine(output, "        --s.sp;");
+            EmitLine(output, "        s.pc = s.stack[s.sp & 0x%X];", Chip8Constants::STACK_LEVELS - 1);
+        }
+        return;
+    case 0x1:
+        EmitLine(output, "        s.pc = 0x%04X;", nnn);
+        return;
+    case 0x2:
+        EmitLine(output, "        s.stack[s.sp & 0x%X] = 0x%04X;", Chip8Constants::STACK_LEVELS - 1, next);
+        EmitLine(output, "        ++s.sp;");
+        EmitLine(output, "        s.pc = 0x%04X;", nnn);
+        return;
+    case 0x3:
+    case 0x4:
+        snprintf(operands, sizeof(operands), "s.registers[0x%X] %s 0x%02X", x, ((opcode >> 12u) == 0x3) ? "==" : "!=", kk);
+        condition = operands;
+        break;
+    case 0x5:
+    case 0x9:
+        snprintf(operands, sizeof(operands), "s.registers[0x%X] %s s.registers[0x%X]", x, ((opcode >> 12u) == 0x5) ? "==" : "!=", y);
+        condition = operands;
+        break;
+    case 0x6:
+        EmitLine(output, "        s.registers[0x%X] = 0x%02X;", x, kk);
+        return;
+    case 0x7:
+        EmitLine(output, "        s.registers[0x%X] += 0x%02X;", x, kk);
+        return;
+    case 0x8:
+        switch (n)
+        {
+        case 0x0:
+            EmitLine(output, "        s.registers[0x%X] = s.registers[0x%X];", x, y);
+            break;
+        case 0x1:
+            EmitLine(output, "        s.registers[0x%X] |= s.registers[0x%X];", x, y);
+            break;
+        case 0x2:
+            EmitLine(output, "        s.registers[0x%X] &= s.registers[0x%X];", x, y);
+            break;
+        case 0x3:
+            EmitLine(output, "        s.registers[0x%X] ^= s.registers[0x%X];", x, y);
+            break;
+        case 0x4:
+            EmitLine(output, "        {");
+            EmitLine(output, "            uint16_t sum = s.registers[0x%X] + s.registers[0x%X];", x, y);
+            EmitLine(output, "            s.registers[0xF] = (sum > UINT8_MAX);");
+            EmitLine(output, "            s.registers[0x%X] = sum & 0xFFu;", x);
+            EmitLine(output, "        }");
+            break;
+        case 0x5:
+            EmitLine(output, "        s.registers[0xF] = (s.registers[0x%X] > s.registers[0x%X]);", x, y);
+            EmitLine(output, "        s.registers[0x%X] -= s.registers[0x%X];", x, y);
+            break;
+        case 0x6:
+            EmitLine(output, "        s.registers[0xF] = (s.registers[0x%X] & 0x1u);", x);
+            EmitLine(output, "        s.registers[0x%X] >>= 1;", x);
+            break;
+        case 0x7:
+            EmitLine(output, "        s.registers[0xF] = (s.registers[0x%X] > s.registers[0x%X]);", y, x);
+            EmitLine(output, "        s.registers[0x%X] -= s.registers[0x%X];", x, y);
+            break;
+        case 0xE:
+            EmitLine(output, "        s.registers[0xF] = (s.registers[0x%X] & 0x80u) >> 0x7u;", x);
+            EmitLine(output, "        s.registers[0x%X] <<= 1;", x);
+            break;
+        }
+        return;
+    case 0xA:
+        EmitLine(output, "        s.index = 0x%04X;", nnn);
+        return;
+    case 0xE:
+        if (n != 0x1 && n != 0xE)
+        {
+            return;
+        }
+
+        //  Keys past the keypad are never pressed.
+        snprintf(operands, sizeof(operands), "%s(s.registers[0x%X] < %u && ((s.keypad >> s.registers[0x%X]) & 1u))",
+                 (n == 0x1) ? "!" : "", x, Chip8Constants::AMOUNT_OF_CHARS, x);
+        condition = operands;
+        break;
+    case 0xF:
+        if (kk == 0x1E)
+        {
+            EmitLine(output, "        s.index += s.registers[0x%X];", x);
+        }
+        else if (kk == 0x29)
+        {
+            EmitLine(output, "        s.index = 0x%04X + (5 * s.registers[0x%X]);", Chip8Constants::FONTSET_START_ADDRESS, x);
+        }
+        //  `F065` loads no register.
+        else if (kk == 0x65 && x > 0)
+        {
+            EmitLine(output, "        for (size_t i = 0; i < 0x%X; i++)", x);
+            EmitLine(output, "        {");
+            EmitLine(output, "            s.registers[i] = s.memory[(s.index + i) & 0x%X];", Chip8Constants::ADDRESS_MASK);
+            EmitLine(output, "        }");
+        }
+        return;
+    }
+
+    EmitLine(output, "        s.pc = (%s) ? 0x%04X : 0x%04X;", condition, skipped, next);
+}
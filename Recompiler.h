@@ -0,0 +1,68 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "Chip8AOT.h"
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//  Recompiles a ROM ahead of time into a C++ translation unit, registering its blocks for the AOT engine.
+//  The control flow is followed from `START_ADDRESS` through jumps, calls, returns and skips, every basic block
+//  becoming a function on the `Chip8State`. Computed jumps (`Bnnn`) have no static target, and the operations
+//  touching the timers, the screen, the randomness or the memory end the blocks and run in the interpreter.
+class Recompiler
+{
+private:
+    //  How an instruction continues the control flow.
+    enum class Flow
+    {
+        //  Continues to the next instruction.
+        Straight,
+
+        //  `1nnn`, `2nnn` and `00EE`, ending the block.
+        Jump,
+        Call,
+        Return,
+
+        //  `3xkk`, `4xkk`, `5xy0`, `9xy0`, `Ex9E` and `ExA1`, continuing at one of the next two instructions.
+        Skip,
+
+        //  Left to the interpreter, ending the block before it.
+        Interpreted
+    };
+
+    std::string name;
+    std::vector<uint8_t> rom;
+
+    //  The amount of instructions of each recovered block, by its starting address.
+    std::map<uint16_t, uint16_t> blocks;
+
+    //  Whether the whole opcode at the address lies inside the ROM, and the opcode.
+    bool InROM(uint32_t address) const;
+    uint16_t Opcode(uint16_t address) const;
+
+    static Flow Classify(uint16_t opcode);
+
+    //  Walks the reachable code from the start address, splitting it into blocks.
+    void Recover();
+
+    //  Writes the statements of an instruction, the ones ending the block set the `Program Counter`.
+    static void EmitInstruction(std::ostream &output, uint16_t opcode, uint16_t address);
+
+public:
+    //  Reads the ROM and recovers its blocks, throws overflow_error if it does not fit in the memory.
+    Recompiler(const char *file_path);
+
+    size_t BlockCount() const { return this->blocks.size(); }
+    size_t InstructionCount() const;
+
+    //  Writes the lines every generated file starts with, once before the programs.
+    static void EmitHeader(std::ostream &output);
+
+    //  Writes the program in a namespace of its own, numbered so several ROMs share a file.
+    void Emit(std::ostream &output, size_t number) const;
+};
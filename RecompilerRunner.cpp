@@ -0,0 +1,39 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "Recompiler.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        printf("Usage: %s <Output C++ file> <ROM>...\n", argv[0]);
+        abort();
+    }
+
+    std::ostringstream generated;
+
+    Recompiler::EmitHeader(generated);
+
+    for (int i = 2; i < argc; i++)
+    {
+        Recompiler recompiler(argv[i]);
+
+        recompiler.Emit(generated, i - 2);
+        printf("%s: %zu blocks, %zu instructions recompiled.\n", argv[i], recompiler.BlockCount(), recompiler.InstructionCount());
+    }
+
+    //  The file is written only once every ROM was recompiled, so a failure keeps the previous one.
+    std::ofstream output(argv[1], std::ios::trunc);
+
+    if (!output.is_open())
+    {
+        throw std::runtime_error("Could not open the output file.");
+    }
+
+    output << generated.str();
+}
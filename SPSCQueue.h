@@ -0,0 +1,58 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+//  A lock-free bounded queue from a single producer thread to a single consumer thread.
+//  The positions only ever grow, each is written by a single side, so neither side waits.
+template <typename T, size_t CAPACITY>
+class SPSCQueue
+{
+private:
+    static_assert(CAPACITY != 0 && (CAPACITY & (CAPACITY - 1)) == 0, "The capacity is a power of two.");
+
+    T items[CAPACITY]{};
+
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+
+public:
+    //  Called by the producer, returns false and drops the item when the queue is full.
+    bool Push(const T &item)
+    {
+        size_t tail = this->tail.load(std::memory_order_relaxed);
+
+        if (tail - this->head.load(std::memory_order_acquire) == CAPACITY)
+        {
+            return false;
+        }
+
+        //  Publishing the item along with the new tail.
+        this->items[tail & (CAPACITY - 1)] = item;
+        this->tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    //  Called by the consumer, the oldest item, or `nullptr` when the queue is empty.
+    T *Front()
+    {
+        size_t head = this->head.load(std::memory_order_relaxed);
+
+        if (head == this->tail.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+
+        return &this->items[head & (CAPACITY - 1)];
+    }
+
+    //  Called by the consumer after `Front`, hands the oldest slot back to the producer.
+    void Pop()
+    {
+        this->head.store(this->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
@@ -0,0 +1,178 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "ThreadPool.h"
+
+//  The index of the worker running on the current thread, or -1 outside of the pool.
+static thread_local long currentWorker = -1;
+
+/***
+ *  Constructor:
+ *      Creates a queue per worker, and starts the workers.
+ *
+ *  @param threadCount The amount of workers, 0 for one per hardware thread.
+ ***/
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+    }
+
+    if (threadCount == 0)
+    {
+        threadCount = 1;
+    }
+
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        this->workers.emplace_back(new Worker());
+    }
+
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        this->threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+/***
+ *  ~ThreadPool:
+ *      Waits for the submitted tasks, then stops and joins the workers.
+ ***/
+ThreadPool::~ThreadPool()
+{
+    this->Wait();
+
+    {
+        std::lock_guard<std::mutex> guard(this->sleepLock);
+        this->stopping = true;
+    }
+
+    this->workAvailable.notify_all();
+
+    for (std::thread &thread : this->threads)
+    {
+        thread.join();
+    }
+}
+
+/***
+ *  Submit:
+ *      Queues a task. Tasks submitted by a worker stay on its own queue, for locality,
+ *      other tasks are spread over the queues and balanced later by stealing.
+ *
+ *  @param task The task to run.
+ ***/
+void ThreadPool::Submit(std::function<void()> task)
+{
+    size_t id = (currentWorker >= 0) ? currentWorker : (this->nextWorker++ % this->workers.size());
+    Worker &worker = *this->workers[id];
+
+    this->pending++;
+
+    {
+        std::lock_guard<std::mutex> guard(worker.lock);
+        worker.tasks.push_back(std::move(task));
+    }
+
+    this->queued++;
+
+    //  Taking the lock makes sure a worker going to sleep either sees the task or gets the notification.
+    {
+        std::lock_guard<std::mutex> guard(this->sleepLock);
+    }
+
+    this->workAvailable.notify_one();
+}
+
+/***
+ *  Wait:
+ *      Blocks until every submitted task has finished.
+ ***/
+void ThreadPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(this->sleepLock);
+    this->allDone.wait(lock, [this]
+                       { return this->pending == 0; });
+}
+
+/***
+ *  WorkerLoop:
+ *      Runs tasks out of the worker's own queue, steals from the other queues when it is empty,
+ *      and sleeps when there are no queued tasks at all.
+ *
+ *  @param id The index of the worker.
+ ***/
+void ThreadPool::WorkerLoop(size_t id)
+{
+    currentWorker = id;
+
+    while (true)
+    {
+        std::function<void()> task;
+
+        if (this->PopLocal(id, task) || this->Steal(id, task))
+        {
+            task();
+
+            if (--this->pending == 0)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(this->sleepLock);
+                }
+
+                this->allDone.notify_all();
+            }
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(this->sleepLock);
+        this->workAvailable.wait(lock, [this]
+                                 { return this->stopping || this->queued > 0; });
+
+        if (this->stopping && this->queued == 0)
+        {
+            return;
+        }
+    }
+}
+
+//  Takes the newest task of the worker's own queue.
+bool ThreadPool::PopLocal(size_t id, std::function<void()> &task)
+{
+    Worker &worker = *this->workers[id];
+    std::lock_guard<std::mutex> guard(worker.lock);
+
+    if (worker.tasks.empty())
+    {
+        return false;
+    }
+
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    this->queued--;
+
+    return true;
+}
+
+//  Takes the oldest task of the first other worker that has one, starting from the next worker.
+bool ThreadPool::Steal(size_t id, std::function<void()> &task)
+{
+    for (size_t i = 1; i < this->workers.size(); i++)
+    {
+        Worker &victim = *this->workers[(id + i) % this->workers.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            this->queued--;
+
+            return true;
+        }
+    }
+
+    return false;
+}
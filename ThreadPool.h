@@ -0,0 +1,57 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+private:
+    //  Every worker owns a queue, it runs its newest task first and others steal its oldest.
+    struct Worker
+    {
+        std::deque<std::function<void()>> tasks;
+        std::mutex lock;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    //  Tasks waiting in the queues, and tasks submitted but not finished yet.
+    std::atomic<size_t> queued{};
+    std::atomic<size_t> pending{};
+
+    //  Sleeping workers wait for tasks, `Wait` waits for every task to finish.
+    std::mutex sleepLock;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    bool stopping{};
+
+    //  The queue tasks submitted from outside of the workers are pushed to next.
+    std::atomic<size_t> nextWorker{};
+
+    void WorkerLoop(size_t id);
+    bool PopLocal(size_t id, std::function<void()> &task);
+    bool Steal(size_t id, std::function<void()> &task);
+
+public:
+    //  Starts a worker per hardware thread when no amount is given.
+    ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    //  Queues a task, a task submitted by a worker is queued on its own queue.
+    void Submit(std::function<void()> task);
+
+    //  Blocks until every submitted task has finished.
+    void Wait();
+
+    size_t Size() const { return this->threads.size(); }
+};
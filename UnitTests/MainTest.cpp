@@ -28,6 +28,746 @@ bool OverflowMemChip8Test(const char* file_path)
     return true;
 }
 
+/**
+ *  SelfModifyingChip8Test:
+ *      This function runs a program which executes an instruction, rewrites it with `Fx55` and executes it again.
+ *      The rewritten instruction points the index at a sprite with its top left pixel on, which is drawn at (0, 0).
+ *
+ * @param file_path The file path to the emulated code to be checked.
+ * @param engine    The engine executing the code.
+ *
+ * @return          Boolean value if the rewritten instruction was the one executed.
+ */
+bool SelfModifyingChip8Test(const char* file_path, Chip8Engine engine)
+{
+    Chip8 chip(file_path, engine);
+
+    chip.Run(100);
+
+    return chip.video[0] != 0;
+}
+
+/**
+ *  ClippedSpriteChip8Test:
+ *      This function runs a program which draws a 8x4 sprite at (60, 30), only its top left 4x2 corner fits on the screen.
+ *
+ * @param file_path The file path to the emulated code to be checked.
+ *
+ * @return          Boolean value if only the pixels inside the screen were drawn.
+ */
+bool ClippedSpriteChip8Test(const char* file_path)
+{
+    Chip8 chip(file_path);
+
+    chip.Run(100);
+
+    for (size_t row = 0; row < Chip8Constants::VIDEO_HEIGHT - 2; row++)
+    {
+        if (chip.video[row] != 0)
+        {
+            return false;
+        }
+    }
+
+    return chip.video[30] == 0xF && chip.video[31] == 0xF;
+}
+
+/**
+ *  DelayTimerChip8Test:
+ *      This function runs a program which sets the delay timer to 5 on its second instruction and spins.
+ *      After 31 instructions 3 frames of 10 instructions ended since, so the timer is at 2.
+ *
+ * @param file_path The file path to the emulated code to be checked.
+ * @param engine    The engine executing the code.
+ *
+ * @return          Boolean value if the timer ticked once per frame.
+ */
+bool DelayTimerChip8Test(const char* file_path, Chip8Engine engine)
+{
+    Chip8 chip(file_path, engine);
+
+    chip.SetInstructionsPerFrame(10);
+    chip.Run(31);
+
+    return chip.DelayTimer() == 2;
+}
+
+/**
+ *  EngineMatchesInterpreterChip8Test:
+ *      This function runs the same code with the given engine and with the interpreter, and compares the screens.
+ *
+ * @param file_path The file path to the emulated code to be checked.
+ * @param engine    The engine compared against the interpreter.
+ *
+ * @return          Boolean value if both screens are the same.
+ */
+bool EngineMatchesInterpreterChip8Test(const char* file_path, Chip8Engine engine)
+{
+    Chip8 interpreted(file_path);
+    Chip8 tested(file_path, engine);
+
+    interpreted.Run(10000);
+    tested.Run(10000);
+
+    return memcmp(interpreted.video, tested.video, sizeof(interpreted.video)) == 0;
+}
+
+/**
+ *  ForkChip8Test:
+ *      This function forks a machine in the middle of a run, runs both machines further, and compares them.
+ *
+ * @param file_path The file path to the emulated code to be checked.
+ * @param engine    The engine executing the code.
+ *
+ * @return          Boolean value if both machines reached the same state.
+ */
+bool ForkChip8Test(const char* file_path, Chip8Engine engine)
+{
+    Chip8 original(file_path, engine);
+
+    original.Run(500);
+
+    std::unique_ptr<Chip8> fork = original.Fork();
+
+    original.Run(5000);
+    fork->Run(5000);
+
+    return memcmp(original.video, fork->video, sizeof(original.video)) == 0 &&
+           original.Cycles() == fork->Cycles() &&
+           original.DelayTimer() == fork->DelayTimer();
+}
+
+/**
+ *  ReplayChip8Test:
+ *      This function records a session of a program drawing at random positions unless key 0 is held,
+ *      saves and loads its input log, replays it on a new machine and compares the machines.
+ *
+ * @param file_path The file path to the emulated code to be checked.
+ *
+ * @return          Boolean value if the replay reached the recorded state.
+ */
+bool ReplayChip8Test(const char* file_path)
+{
+    std::string logPath = (std::filesystem::temp_directory_path() / "Chip8ReplayTest.log").string();
+    Chip8 recorded(file_path);
+    Chip8 replayed(file_path, Chip8Engine::Threaded);
+    InputLog recording;
+    InputLog loaded;
+
+    recording.seed = 1234;
+    recorded.Seed(recording.seed);
+
+    //  Holding key 0 on every third stretch of cycles.
+    for (size_t stretch = 0; stretch < 30; stretch++)
+    {
+        recorded.SetKeypadMask((stretch % 3 == 0) ? 0x1 : 0x0);
+        recording.Record(recorded.Cycles(), recorded.KeypadMask());
+        recorded.Run(37 + stretch);
+    }
+
+    recording.endCycle = recorded.Cycles();
+    recording.Save(logPath.c_str());
+    loaded.Load(logPath.c_str());
+    std::filesystem::remove(logPath);
+
+    loaded.Replay(replayed);
+
+    return memcmp(recorded.video, replayed.video, sizeof(recorded.video)) == 0 &&
+           recorded.Cycles() == replayed.Cycles() &&
+           loaded.Changes() == recording.Changes();
+}
+
+/**
+ *  LockstepMatchesInterpreterChip8Test:
+ *      This function runs the same code on every lane of a lockstep engine and with an interpreter seeded as each lane,
+ *      and compares the registers, memory and screen of every lane, and whether lanes diverged into scalar machines.
+ *
+ * @param file_path The file path to the emulated code to be checked.
+ * @param lanes     The amount of lanes stepped together.
+ * @param diverges  Whether lanes are expected to diverge past the limit, and run on scalar machines.
+ *
+ * @return          Boolean value if every lane state is the same as the interpreted one.
+ */
+bool LockstepMatchesInterpreterChip8Test(const char* file_path, size_t lanes, bool diverges)
+{
+    constexpr uint64_t seed = 1;
+    Chip8Lockstep lockstep(file_path, lanes, seed);
+
+    lockstep.Run(10000);
+
+    if ((lockstep.ScalarLanes() > 0) != diverges)
+    {
+        return false;
+    }
+
+    for (size_t lane = 0; lane < lanes; lane++)
+    {
+        Chip8 interpreted(file_path);
+
+        interpreted.Seed(seed + lane);
+        interpreted.Run(10000);
+
+        if (memcmp(interpreted.video, lockstep.Video(lane), sizeof(interpreted.video)) != 0)
+        {
+            return false;
+        }
+
+        for (uint8_t x = 0; x < Chip8Constants::BASE_REG_AMOUNT; x++)
+        {
+            if (interpreted.Register(x) != lockstep.ReadRegister(lane, x))
+            {
+                return false;
+            }
+        }
+
+        for (uint16_t address = 0; address < Chip8Constants::RAM_SIZE_IN_BYTES; address++)
+        {
+            if (interpreted.ReadMemory(address) != lockstep.ReadMemory(lane, address))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ *  ROMCacheChip8Test:
+ *      This function loads a ROM twice and a copy of it once, and checks that every load returns the same image,
+ *      and that machines built from it hold the ROM in their memory.
+ *
+ * @param file_path The file path to the emulated code to be checked.
+ *
+ * @return          Boolean value if the image was shared and loaded.
+ */
+bool ROMCacheChip8Test(const char* file_path)
+{
+    std::string copyPath = (std::filesystem::temp_directory_path() / "Chip8ROMCacheTest.ch8").string();
+
+    std::filesystem::copy_file(file_path, copyPath, std::filesystem::copy_options::overwrite_existing);
+
+    std::shared_ptr<const ROMImage> image = ROMCache::Instance().Load(file_path);
+    std::shared_ptr<const ROMImage> again = ROMCache::Instance().Load(file_path);
+    std::shared_ptr<const ROMImage> copy = ROMCache::Instance().Load(copyPath.c_str());
+    Chip8 chip(copyPath.c_str());
+
+    std::filesystem::remove(copyPath);
+
+    if (image == nullptr || image != again || image != copy || ROMCache::Instance().Load("UnitTests/NoSuchCode") != nullptr)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < image->size; i++)
+    {
+        if (chip.ReadMemory(Chip8Constants::START_ADDRESS + i) != image->bytes[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ *  IdleLoopChip8Test:
+ *      This function runs a program which polls the delay timer until it is 0, waits for a key into V1
+ *      and jumps to itself, for a billion cycles before a key is pressed and a billion after.
+ *      Executing them one by one would take minutes, skipping the idle iterations takes no time.
+ *
+ * @param file_path The file path to the emulated code to be checked.
+ * @param engine    The engine executing the code.
+ *
+ * @return          Boolean value if both runs ended in the state executing them reaches.
+ */
+bool IdleLoopChip8Test(const char* file_path, Chip8Engine engine)
+{
+    Chip8 chip(file_path, engine);
+
+    chip.Run(1000000000);
+
+    if (chip.Cycles() != 1000000000 || chip.Register(0x0) != 0 || chip.Register(0x1) != 0)
+    {
+        return false;
+    }
+
+    chip.SetKeypadMask(1u << 0x5);
+    chip.Run(1000000000);
+
+    return chip.Cycles() == 2000000000 && chip.Register(0x1) == 0x5;
+}
+
+/**
+ *  FrameBufferChip8Test:
+ *      This function runs a program on its own thread, publishing a frame after every instruction which drew,
+ *      while this thread takes the newest frames. The frames taken must only move forward, their changed rows
+ *      must add up to every row the program drew, and the last one must be the final screen.
+ *
+ * @param file_path The file path to the emulated code to be checked.
+ *
+ * @return          Boolean value if the frames were handed over whole and in order.
+ */
+bool FrameBufferChip8Test(const char* file_path)
+{
+    Chip8 chip(file_path);
+    FrameBuffer frames;
+    std::atomic<bool> done{false};
+    uint32_t drawnRows = 0;
+
+    std::thread emulation([&]()
+    {
+        for (size_t i = 0; i < 100000; i++)
+        {
+            chip.Cycle();
+
+            uint32_t dirtyRows = chip.TakeDirtyRows();
+
+            if (dirtyRows != 0)
+            {
+                drawnRows |= dirtyRows;
+                frames.Publish(chip.video, dirtyRows, chip.Cycles());
+            }
+        }
+
+        done.store(true);
+    });
+
+    uint64_t lastCycles = 0;
+    uint32_t takenRows = 0;
+    const VideoFrame* last = nullptr;
+    bool ordered = true;
+
+    //  Taking the last frame after the thread is done, so it is seen whatever the scheduling was.
+    for (bool finished = false; !finished;)
+    {
+        finished = done.load();
+
+        for (const VideoFrame* frame = frames.Acquire(); frame != nullptr; frame = frames.Acquire())
+        {
+            ordered = ordered && (frame->cycles > lastCycles);
+            lastCycles = frame->cycles;
+            takenRows |= frame->dirtyRows;
+            last = frame;
+        }
+    }
+
+    emulation.join();
+
+    return ordered && last != nullptr && takenRows == drawnRows &&
+           memcmp(last->video, chip.video, sizeof(last->video)) == 0;
+}
+
+/**
+ *  InputQueueChip8Test:
+ *      This function queues presses and releases with given times, and checks that applying them
+ *      up to a time changes the keypad by the events until it only, and that a key pressed and released
+ *      between two updates is held for one of them. Then it queues events on another thread
+ *      while this thread applies them, and checks that the keypad ends as the last events left it.
+ *
+ * @return          Boolean value if the events were applied in order and at their time.
+ */
+bool InputQueueChip8Test()
+{
+    InputQueue inputs;
+
+    inputs.Push({100, 0x5, true});
+    inputs.Push({200, 0x3, true});
+    inputs.Push({300, 0x5, false});
+
+    if (inputs.Apply(0, 50) != 0 ||
+        inputs.Apply(0, 150) != (1u << 0x5) ||
+        inputs.Apply(1u << 0x5, 250) != ((1u << 0x5) | (1u << 0x3)) ||
+        inputs.Apply((1u << 0x5) | (1u << 0x3), 1000) != (1u << 0x3))
+    {
+        return false;
+    }
+
+    //  A press released before the keypad is updated holds the key until the next update.
+    inputs.Push({100, 0x7, true});
+    inputs.Push({200, 0x7, false});
+
+    if (inputs.Apply(0, 1000) != (1u << 0x7) || inputs.Apply(1u << 0x7, 1000) != 0 || inputs.Pending())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < InputQueueConstants::CAPACITY; i++)
+    {
+        inputs.Push({0, 0x0, true});
+    }
+
+    if (inputs.Push({0, 0x0, true}) || inputs.Apply(0, 0) != 0x1)
+    {
+        return false;
+    }
+
+    //  Every key is pressed and released in turn, the last round leaves the even keys pressed.
+    constexpr size_t rounds = 10000;
+    std::atomic<bool> done{false};
+
+    std::thread input([&]()
+    {
+        for (size_t round = 0; round < rounds; round++)
+        {
+            for (uint8_t key = 0; key < Chip8Constants::AMOUNT_OF_CHARS; key++)
+            {
+                bool pressed = (round % 2 == 0) || (round == rounds - 1 && key % 2 == 0);
+
+                //  Retrying while the queue is full, until this thread applies some.
+                while (!inputs.Push({round, key, pressed}))
+                {
+                }
+            }
+        }
+
+        done.store(true);
+    });
+
+    uint16_t keys = 0;
+
+    //  Every call leaves at most the events undoing its own changes, the last ones follow once the input thread ends.
+    while (!done.load() || inputs.Pending())
+    {
+        keys = inputs.Apply(keys, rounds);
+    }
+
+    input.join();
+
+    return keys == 0x5555;
+}
+
+/**
+ *  BeeperChip8Test:
+ *      This function starts the tone a half and stops it three quarters into the time a buffer stands for,
+ *      and checks that the buffer is silent but for the quarter in between.
+ *
+ * @return          Boolean value if the tone started and stopped at the matching samples.
+ */
+bool BeeperChip8Test()
+{
+    Beeper beeper;
+    int16_t samples[BeeperConstants::DEFAULT_BUFFER_SAMPLES];
+
+    //  The first buffer starts the time the next one stands for.
+    beeper.Fill(samples, BeeperConstants::DEFAULT_BUFFER_SAMPLES, 1000);
+
+    beeper.SetTone(true, 1500);
+    beeper.SetTone(true, 1600);
+    beeper.SetTone(false, 1750);
+    beeper.SetTone(true, 2500);
+    beeper.Fill(samples, BeeperConstants::DEFAULT_BUFFER_SAMPLES, 2000);
+
+    for (size_t i = 0; i < BeeperConstants::DEFAULT_BUFFER_SAMPLES; i++)
+    {
+        bool sounding = (i >= BeeperConstants::DEFAULT_BUFFER_SAMPLES / 2 && i < BeeperConstants::DEFAULT_BUFFER_SAMPLES * 3 / 4);
+
+        if ((samples[i] != 0) != sounding)
+        {
+            return false;
+        }
+    }
+
+    //  The change after the buffer starts the next one.
+    beeper.Fill(samples, BeeperConstants::DEFAULT_BUFFER_SAMPLES, 3000);
+
+    return samples[0] == 0 && samples[BeeperConstants::DEFAULT_BUFFER_SAMPLES / 2] == BeeperConstants::AMPLITUDE;
+}
+
+/**
+ *  FrameHashChip8Test:
+ *      Hashes the screen of a program, then the screen with each single pixel flipped,
+ *      and the screen with its rows swapped.
+ *
+ *  @param file_path    The program drawing the screen.
+ *
+ *  @return     `true` if both versions of the hash agree and every change of the screen changes it.
+ */
+bool FrameHashChip8Test(const char* file_path)
+{
+    Chip8 chip8(file_path);
+    uint64_t video[Chip8Constants::VIDEO_HEIGHT];
+
+    chip8.Run(1000);
+    memcpy(video, chip8.video, sizeof(video));
+
+    uint64_t hash = HashFrame(video);
+
+    if (hash != HashFrameScalar(video))
+    {
+        return false;
+    }
+
+    for (size_t row = 0; row < Chip8Constants::VIDEO_HEIGHT; row++)
+    {
+        for (size_t column = 0; column < Chip8Constants::VIDEO_WIDTH; column++)
+        {
+            video[row] ^= 1ull << column;
+
+            bool changed = HashFrame(video) != hash && HashFrame(video) == HashFrameScalar(video);
+
+            video[row] ^= 1ull << column;
+
+            if (!changed)
+            {
+                return false;
+            }
+        }
+    }
+
+    //  The same rows in other positions are another screen.
+    size_t row = 0;
+
+    while (row + 1 < Chip8Constants::VIDEO_HEIGHT && video[row] == video[row + 1])
+    {
+        row++;
+    }
+
+    std::swap(video[row], video[(row + 1) % Chip8Constants::VIDEO_HEIGHT]);
+
+    return HashFrame(video) != hash;
+}
+
+/**
+ *  FrameRecorderChip8Test:
+ *      Exports the screen of a program at the end of each frame in both formats,
+ *      reads the deltas back and checks the size of the Y4M stream.
+ *
+ *  @param file_path    The program drawing the screen.
+ *
+ *  @return     `true` if every screen was written and read back as it was pushed.
+ */
+bool FrameRecorderChip8Test(const char* file_path)
+{
+    std::string deltaPath = (std::filesystem::temp_directory_path() / "Chip8RecorderTest.c8fd").string();
+    std::string y4mPath = (std::filesystem::temp_directory_path() / "Chip8RecorderTest.y4m").string();
+    std::vector<VideoFrame> screens;
+    Chip8 chip8(file_path);
+
+    {
+        FrameRecorder deltas(deltaPath.c_str(), FrameFormat::Delta);
+        FrameRecorder y4m(y4mPath.c_str(), FrameFormat::Y4M);
+
+        for (size_t frame = 0; frame < 200; frame++)
+        {
+            chip8.Run(Chip8Constants::DEFAULT_INSTRUCTIONS_PER_FRAME);
+            screens.emplace_back();
+            memcpy(screens.back().video, chip8.video, sizeof(chip8.video));
+
+            //  Waiting for the encoder instead of dropping, as every screen is compared.
+            while (!deltas.Push(chip8.video, chip8.Cycles()))
+            {
+                std::this_thread::yield();
+            }
+
+            while (!y4m.Push(chip8.video, chip8.Cycles()))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::vector<VideoFrame> loaded = FrameRecorder::LoadDelta(deltaPath.c_str());
+    size_t y4mSize = std::filesystem::file_size(y4mPath);
+    size_t deltaSize = std::filesystem::file_size(deltaPath);
+
+    std::filesystem::remove(deltaPath);
+    std::filesystem::remove(y4mPath);
+
+    //  The deltas of a mostly still screen are smaller than the screens.
+    if (loaded.size() != screens.size() || deltaSize >= screens.size() * FrameRecorderConstants::FRAME_BYTES)
+    {
+        return false;
+    }
+
+    for (size_t frame = 0; frame < screens.size(); frame++)
+    {
+        if (memcmp(loaded[frame].video, screens[frame].video, sizeof(screens[frame].video)) != 0)
+        {
+            return false;
+        }
+    }
+
+    //  Each frame is its header and a byte per pixel, after the stream header.
+    return y4mSize == strlen("YUV4MPEG2 W64 H32 F60:1 Ip A1:1 Cmono\n") +
+                          screens.size() * (strlen("FRAME\n") + Chip8Constants::VIDEO_WIDTH * Chip8Constants::VIDEO_HEIGHT);
+}
+
+/**
+ *  UpscalerChip8Test:
+ *      Renders the screen of a program after each frame with the SIMD and the portable kernels,
+ *      then renders an empty screen, which leaves the pixels lit before faded.
+ *
+ *  @param file_path    The program drawing the screen.
+ *  @param filter       The scaling filter.
+ *  @param scale        The output pixels per screen pixel.
+ *
+ *  @return     `true` if both kernels render the same pixels, and every lit pixel is white when not rounded.
+ */
+bool UpscalerChip8Test(const char* file_path, ScaleFilter filter, uint32_t scale)
+{
+    const uint8_t persistence = 192;
+    Chip8 chip8(file_path);
+    Upscaler vectorized(scale, filter, persistence, true);
+    Upscaler portable(scale, filter, persistence, false);
+    size_t pitch = vectorized.OutputWidth() * sizeof(uint32_t);
+    std::vector<uint32_t> expected(vectorized.OutputWidth() * vectorized.OutputHeight());
+    std::vector<uint32_t> rendered(expected.size());
+    uint64_t empty[Chip8Constants::VIDEO_HEIGHT] = {};
+
+    for (size_t frame = 0; frame < 60; frame++)
+    {
+        chip8.Run(Chip8Constants::DEFAULT_INSTRUCTIONS_PER_FRAME);
+        vectorized.Render(chip8.video, rendered.data(), pitch);
+        portable.Render(chip8.video, expected.data(), pitch);
+
+        if (rendered != expected)
+        {
+            return false;
+        }
+    }
+
+    //  Every pixel of a lit screen pixel is white, Scale2x may round its corners off.
+    for (size_t row = 0; row < Chip8Constants::VIDEO_HEIGHT && filter == ScaleFilter::Nearest; row++)
+    {
+        for (size_t column = 0; column < Chip8Constants::VIDEO_WIDTH; column++)
+        {
+            bool on = (chip8.video[row] >> (Chip8Constants::VIDEO_WIDTH - 1 - column)) & 1u;
+            uint32_t pixel = rendered[(row * scale + scale / 2) * vectorized.OutputWidth() + column * scale + scale / 2];
+
+            if (on && pixel != 0xFFFFFFFFu)
+            {
+                return false;
+            }
+        }
+    }
+
+    vectorized.Render(empty, rendered.data(), pitch);
+    portable.Render(empty, expected.data(), pitch);
+
+    //  A pixel lit in the last frame keeps `192 / 256` of its brightness.
+    return rendered == expected && vectorized.Fading() &&
+           std::find(rendered.begin(), rendered.end(), 0xBFBFBFBFu) != rendered.end() &&
+           std::find(rendered.begin(), rendered.end(), 0xFFFFFFFFu) == rendered.end();
+}
+
+/**
+ *  RecompilerChip8Test:
+ *      Recompiles the programs the AOT tests run again, and compares the code with the generated file compiled into the tests.
+ *
+ *  @param recompiled_path  The generated file.
+ *
+ *  @return     `true` if the file is up to date and its programs registered themselves.
+ */
+bool RecompilerChip8Test(const char* recompiled_path)
+{
+    std::ifstream file(recompiled_path);
+    std::ostringstream expected;
+    std::ostringstream generated;
+
+    expected << file.rdbuf();
+
+    Recompiler::EmitHeader(generated);
+    Recompiler(OPCODE_TEST_FILE).Emit(generated, 0);
+    Recompiler(SELF_MODIFYING_FILE).Emit(generated, 1);
+
+    return file.is_open() && generated.str() == expected.str() && Chip8AOT::ProgramCount() == 2;
+}
+
+/**
+ *  DebuggerChip8Test:
+ *      Debugs the opcode test program: stops at the call at 0x2BE and steps over it, stops before `F155` writes 0x3E8,
+ *      after V6 is set to 0x89, before `F633` writes 0x3E8 and `F265` reads 0x3E9, then runs to the final loop.
+ *      The production engine runs the same program without any hook.
+ *
+ *  @param file_path    The program.
+ *
+ *  @return     `true` if every stop is the expected one, with the machine stopped at the right instruction.
+ */
+bool DebuggerChip8Test(const char* file_path)
+{
+    Chip8 debugged(file_path);
+    Chip8 production(file_path);
+    Chip8 interpreted(file_path);
+    Chip8DebugEngine debugger(debugged);
+    Chip8ProductionEngine engine(production);
+
+    debugger.SetBreakpoint(0x2BE);
+
+    Chip8Stop breakpoint = debugger.Run(10000);
+    uint8_t sp = debugger.State().sp;
+    Chip8Stop steppedOver = debugger.StepOver(10000);
+    bool returned = debugger.State().sp == sp;
+    Chip8Stop stepped = debugger.Step();
+
+    debugger.WatchWrites(0x3E8);
+    Chip8Stop store = debugger.Run(10000);
+    uint16_t storePC = debugger.State().pc;
+    uint8_t stored = debugged.ReadMemory(0x3E8);
+
+    debugger.WatchRegister(0x6, RegisterCondition::Equals, 0x89);
+    Chip8Stop condition = debugger.Run(10000);
+    uint16_t conditionPC = debugger.State().pc;
+
+    debugger.WatchReads(0x3E9);
+    Chip8Stop digits = debugger.Run(10000);
+    Chip8Stop load = debugger.Run(10000);
+    uint16_t loadPC = debugger.State().pc;
+    Chip8Stop end = debugger.RunTo(0x3DC, 10000);
+
+    engine.Run(10000);
+    interpreted.Run(10000);
+
+    return breakpoint.reason == Chip8StopReason::Breakpoint && breakpoint.address == 0x2BE &&
+           steppedOver.reason == Chip8StopReason::Stepped && steppedOver.address == 0x2C0 && returned &&
+           stepped.reason == Chip8StopReason::Stepped && stepped.address == 0x2C2 &&
+           store.reason == Chip8StopReason::WriteWatchpoint && store.address == 0x3E8 && storePC == 0x3A0 && stored == 0 &&
+           condition.reason == Chip8StopReason::RegisterCondition && condition.address == 0x6 && conditionPC == 0x3BC &&
+           digits.reason == Chip8StopReason::WriteWatchpoint && digits.address == 0x3E8 &&
+           load.reason == Chip8StopReason::ReadWatchpoint && load.address == 0x3E9 && loadPC == 0x3BE &&
+           end.reason == Chip8StopReason::Stepped && end.address == 0x3DC &&
+           memcmp(production.video, interpreted.video, sizeof(production.video)) == 0;
+}
+
+/**
+ *  VariantChip8Test:
+ *      Runs a program shifting with Vy, storing registers, switching to high resolution,
+ *      drawing the large 0 and scrolling it right, on a variant built from the given policy.
+ *
+ *  @param file_path    The program.
+ *  @param shifted      The value V0 holds after shifting 3 into it, or shifting 5.
+ *  @param index        The `Index Register` after storing 3 registers at 0x300.
+ *
+ *  @return     `true` if the variant ends in the state its quirks lead to.
+ */
+template <typename Policy>
+bool VariantChip8Test(const char* file_path, uint8_t shifted, uint16_t index)
+{
+    //  The XO-CHIP memory is too big for the stack.
+    std::unique_ptr<Chip8Variant<Policy>> variant = std::make_unique<Chip8Variant<Policy>>(file_path);
+
+    variant->Run(6);
+
+    if (variant->Register(0x0) != shifted || variant->Register(0xF) != 1 || variant->Index() != index ||
+        variant->ReadMemory(0x302) != 7)
+    {
+        return false;
+    }
+
+    variant->Run(100);
+
+    if (!Policy::HIRES)
+    {
+        //  Without high resolution the program draws the empty memory after it.
+        return variant->Width() == 64 && variant->Pixel(4, 0) == 0;
+    }
+
+    //  The top of the large 0 is a full byte, its third row only has its outer two columns.
+    return variant->Width() == 128 && variant->Height() == 64 &&
+           variant->Pixel(3, 0) == 0 && variant->Pixel(4, 0) == 1 && variant->Pixel(11, 0) == 1 && variant->Pixel(12, 0) == 0 &&
+           variant->Pixel(5, 2) == 1 && variant->Pixel(6, 2) == 0 && variant->Pixel(10, 2) == 1;
+}
+
 int main()
 {
     if(
@@ -35,7 +775,75 @@ int main()
         !OverflowMemChip8Test(MEMORY_OVERFLOW_FILE) &&
 
         //  This Should return `true`, as it is normal sized file.
-        OverflowMemChip8Test(NORMAL_MEMORY_FILE)
+        OverflowMemChip8Test(NORMAL_MEMORY_FILE) &&
+
+        //  These Should return `true`, as the decoded instruction is dropped once it is overwritten.
+        SelfModifyingChip8Test(SELF_MODIFYING_FILE, Chip8Engine::Interpreter) &&
+        SelfModifyingChip8Test(SELF_MODIFYING_FILE, Chip8Engine::JIT) &&
+        SelfModifyingChip8Test(SELF_MODIFYING_FILE, Chip8Engine::Threaded) &&
+        SelfModifyingChip8Test(SELF_MODIFYING_FILE, Chip8Engine::AOT) &&
+
+        //  This Should return `true`, as the sprite is clipped at the right and bottom edges.
+        ClippedSpriteChip8Test(CLIPPED_SPRITE_FILE) &&
+
+        //  These Should return `true`, as the timers tick by emulated frames and not by instructions.
+        DelayTimerChip8Test(DELAY_TIMER_FILE, Chip8Engine::Interpreter) &&
+        DelayTimerChip8Test(DELAY_TIMER_FILE, Chip8Engine::JIT) &&
+
+        //  These Should return `true`, as every engine behaves as the interpreted operations.
+        EngineMatchesInterpreterChip8Test(OPCODE_TEST_FILE, Chip8Engine::JIT) &&
+        EngineMatchesInterpreterChip8Test(OPCODE_TEST_FILE, Chip8Engine::Threaded) &&
+        EngineMatchesInterpreterChip8Test(OPCODE_TEST_FILE, Chip8Engine::AOT) &&
+
+        //  These Should return `true`, as a fork holds the whole machine state.
+        ForkChip8Test(OPCODE_TEST_FILE, Chip8Engine::Interpreter) &&
+        ForkChip8Test(OPCODE_TEST_FILE, Chip8Engine::JIT) &&
+
+        //  This Should return `true`, as the seed and the keypad changes reproduce a session.
+        ReplayChip8Test(RANDOM_KEYS_FILE) &&
+
+        //  These Should return `true`, as every lane behaves as the interpreted operations,
+        //  the lanes branching on random bytes apart being masked, and moved to scalar machines past the limit.
+        LockstepMatchesInterpreterChip8Test(OPCODE_TEST_FILE, 40, false) &&
+        LockstepMatchesInterpreterChip8Test(DIVERGING_FILE, 40, true) &&
+
+        //  These Should return `true`, as waiting for the delay timer or a key is skipped.
+        IdleLoopChip8Test(IDLE_LOOP_FILE, Chip8Engine::Interpreter) &&
+        IdleLoopChip8Test(IDLE_LOOP_FILE, Chip8Engine::JIT) &&
+        IdleLoopChip8Test(IDLE_LOOP_FILE, Chip8Engine::Threaded) &&
+
+        //  This Should return `true`, as equal ROM contents are cached once.
+        ROMCacheChip8Test(OPCODE_TEST_FILE) &&
+
+        //  This Should return `true`, as the newest frame and every changed row reach the other thread.
+        FrameBufferChip8Test(OPCODE_TEST_FILE) &&
+
+        //  This Should return `true`, as the keys change at the time they were queued with.
+        InputQueueChip8Test() &&
+
+        //  This Should return `true`, as the tone follows the sound timer to the sample.
+        BeeperChip8Test() &&
+
+        //  This Should return `true`, as the frame hash is the same on every CPU and sees every pixel.
+        FrameHashChip8Test(OPCODE_TEST_FILE) &&
+
+        //  This Should return `true`, as the exported frames hold every screen pushed.
+        FrameRecorderChip8Test(OPCODE_TEST_FILE) &&
+
+        //  These Should return `true`, as the SIMD upscaling renders the same pixels as the portable one.
+        UpscalerChip8Test(OPCODE_TEST_FILE, ScaleFilter::Nearest, 5) &&
+        UpscalerChip8Test(OPCODE_TEST_FILE, ScaleFilter::Scale2x, 4) &&
+
+        //  This Should return `true`, as the recompiled programs are generated out of the current ROMs.
+        RecompilerChip8Test(RECOMPILED_FILE) &&
+
+        //  This Should return `true`, as the debugger stops at every hook and the production engine at none.
+        DebuggerChip8Test(OPCODE_TEST_FILE) &&
+
+        //  These Should return `true`, as each variant resolves its own quirks.
+        VariantChip8Test<VIPPolicy>(VARIANT_FILE, 1, 0x303) &&
+        VariantChip8Test<SChipPolicy>(VARIANT_FILE, 2, 0x300) &&
+        VariantChip8Test<XOChipPolicy>(VARIANT_FILE, 1, 0x303)
     )
     {
         printf("Success - :-)\n");
@@ -1,8 +1,90 @@
+#include <Beeper.h>
 #include <Chip8.h>
+#include <Chip8Debugger.h>
+#include <Chip8Lockstep.h>
+#include <Chip8Variant.h>
+#include <FrameBuffer.h>
+#include <FrameHash.h>
+#include <FrameRecorder.h>
+#include <InputLog.h>
+#include <InputQueue.h>
+#include <ROMCache.h>
+#include <Recompiler.h>
+#include <Upscaler.h>
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <cstring>
 
 const char* MEMORY_OVERFLOW_FILE    = "UnitTests/MemoryOverflowCode";
 const char* NORMAL_MEMORY_FILE      = "UnitTests/NormalSizeCode";
+const char* SELF_MODIFYING_FILE     = "UnitTests/SelfModifyingCode";
+const char* OPCODE_TEST_FILE        = "UnitTests/test_opcode.ch8";
+const char* CLIPPED_SPRITE_FILE     = "UnitTests/ClippedSpriteCode";
+const char* DELAY_TIMER_FILE        = "UnitTests/DelayTimerCode";
+const char* RANDOM_KEYS_FILE        = "UnitTests/RandomKeysCode";
+const char* IDLE_LOOP_FILE          = "UnitTests/IdleLoopCode";
+const char* VARIANT_FILE            = "UnitTests/VariantCode";
+const char* DIVERGING_FILE          = "UnitTests/DivergingCode";
+const char* RECOMPILED_FILE         = "UnitTests/RecompiledCode.cpp";
 
 //  This function tests the Overflow error handling when constructing a `Chip8` object
 bool OverflowMemChip8Test(const char* file_path);
+
+//  This function tests that code rewritten by the emulated program is executed in its new form
+bool SelfModifyingChip8Test(const char* file_path, Chip8Engine engine);
+
+//  This function tests that an engine draws the same screen as the interpreter
+bool EngineMatchesInterpreterChip8Test(const char* file_path, Chip8Engine engine);
+
+
+//  This function tests that a sprite drawn over the bottom right corner is clipped at the screen edges
+bool ClippedSpriteChip8Test(const char* file_path);
+
+//  This function tests that the delay timer ticks once a frame of emulated instructions
+bool DelayTimerChip8Test(const char* file_path, Chip8Engine engine);
+
+//  This function tests that a forked machine continues as the machine it was forked from
+bool ForkChip8Test(const char* file_path, Chip8Engine engine);
+
+//  This function tests that a recorded session replays into the same machine state
+bool ReplayChip8Test(const char* file_path);
+
+//  This function tests that every lane of the lockstep engine ends in the same state as an interpreter seeded as it
+bool LockstepMatchesInterpreterChip8Test(const char* file_path, size_t lanes, bool diverges);
+
+//  This function tests that a ROM is read once and that copies of it share one cached image
+bool ROMCacheChip8Test(const char* file_path);
+
+//  This function tests that idle loops are fast-forwarded to the event ending them
+bool IdleLoopChip8Test(const char* file_path, Chip8Engine engine);
+
+//  This function tests that frames published on one thread reach another as the newest frame, without losing changed rows
+bool FrameBufferChip8Test(const char* file_path);
+
+//  This function tests that queued input events are applied in order, once their time is reached
+bool InputQueueChip8Test();
+
+//  This function tests that the beeper tone starts and stops at the samples matching the time of the changes
+bool BeeperChip8Test();
+
+//  This function tests that the vectorized frame hash matches the portable one, and that any changed pixel changes it
+bool FrameHashChip8Test(const char* file_path);
+
+//  This function tests that the exported frames read back as the screens pushed, in both formats
+bool FrameRecorderChip8Test(const char* file_path);
+
+//  This function tests that the SIMD upscaling kernels render what the portable ones do, fading the pixels turned off
+bool UpscalerChip8Test(const char* file_path, ScaleFilter filter, uint32_t scale);
+
+//  This function tests that the recompiled code compiled into the tests is what the recompiler generates out of the ROMs
+bool RecompilerChip8Test(const char* recompiled_path);
+
+//  This function tests that the debugger stops at breakpoints, watchpoints and register conditions, and steps
+bool DebuggerChip8Test(const char* file_path);
+
+//  This function tests that each variant executes its quirks, resolution and scrolling
+template <typename Policy>
+bool VariantChip8Test(const char* file_path, uint8_t shifted, uint16_t index);
@@ -0,0 +1,918 @@
+//  Generated by the recompiler out of the ROMs below, recompile them instead of editing it.
+
+#include <Chip8AOT.h>
+
+//  UnitTests/test_opcode.ch8: 81 blocks, 153 instructions.
+namespace Recompiled0
+{
+    const uint8_t rom[] = {
+        0x12, 0x4E, 0xEA, 0xAC, 0xAA, 0xEA, 0xCE, 0xAA, 0xAA, 0xAE, 0xE0, 0xA0, 0xA0, 0xE0, 0xC0, 0x40,
+        0x40, 0xE0, 0xE0, 0x20, 0xC0, 0xE0, 0xE0, 0x60, 0x20, 0xE0, 0xA0, 0xE0, 0x20, 0x20, 0x60, 0x40,
+        0x20, 0x40, 0xE0, 0x80, 0xE0, 0xE0, 0xE0, 0x20, 0x20, 0x20, 0xE0, 0xE0, 0xA0, 0xE0, 0xE0, 0xE0,
+        0x20, 0xE0, 0x40, 0xA0, 0xE0, 0xA0, 0xE0, 0xC0, 0x80, 0xE0, 0xE0, 0x80, 0xC0, 0x80, 0xA0, 0x40,
+        0xA0, 0xA0, 0xA2, 0x02, 0xDA, 0xB4, 0x00, 0xEE, 0xA2, 0x02, 0xDA, 0xB4, 0x13, 0xDC, 0x68, 0x01,
+        0x69, 0x05, 0x6A, 0x0A, 0x6B, 0x01, 0x65, 0x2A, 0x66, 0x2B, 0xA2, 0x16, 0xD8, 0xB4, 0xA2, 0x3E,
+        0xD9, 0xB4, 0xA2, 0x02, 0x36, 0x2B, 0xA2, 0x06, 0xDA, 0xB4, 0x6B, 0x06, 0xA2, 0x1A, 0xD8, 0xB4,
+        0xA2, 0x3E, 0xD9, 0xB4, 0xA2, 0x06, 0x45, 0x2A, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x0B, 0xA2, 0x1E,
+        0xD8, 0xB4, 0xA2, 0x3E, 0xD9, 0xB4, 0xA2, 0x06, 0x55, 0x60, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x10,
+        0xA2, 0x26, 0xD8, 0xB4, 0xA2, 0x3E, 0xD9, 0xB4, 0xA2, 0x06, 0x76, 0xFF, 0x46, 0x2A, 0xA2, 0x02,
+        0xDA, 0xB4, 0x6B, 0x15, 0xA2, 0x2E, 0xD8, 0xB4, 0xA2, 0x3E, 0xD9, 0xB4, 0xA2, 0x06, 0x95, 0x60,
+        0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x1A, 0xA2, 0x32, 0xD8, 0xB4, 0xA2, 0x3E, 0xD9, 0xB4, 0x22, 0x42,
+        0x68, 0x17, 0x69, 0x1B, 0x6A, 0x20, 0x6B, 0x01, 0xA2, 0x0A, 0xD8, 0xB4, 0xA2, 0x36, 0xD9, 0xB4,
+        0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x06, 0xA2, 0x2A, 0xD8, 0xB4, 0xA2, 0x0A, 0xD9, 0xB4, 0xA2, 0x06,
+        0x87, 0x50, 0x47, 0x2A, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x0B, 0xA2, 0x2A, 0xD8, 0xB4, 0xA2, 0x0E,
+        0xD9, 0xB4, 0xA2, 0x06, 0x67, 0x2A, 0x87, 0xB1, 0x47, 0x2B, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x10,
+        0xA2, 0x2A, 0xD8, 0xB4, 0xA2, 0x12, 0xD9, 0xB4, 0xA2, 0x06, 0x66, 0x78, 0x67, 0x1F, 0x87, 0x62,
+        0x47, 0x18, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x15, 0xA2, 0x2A, 0xD8, 0xB4, 0xA2, 0x16, 0xD9, 0xB4,
+        0xA2, 0x06, 0x66, 0x78, 0x67, 0x1F, 0x87, 0x63, 0x47, 0x67, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x1A,
+        0xA2, 0x2A, 0xD8, 0xB4, 0xA2, 0x1A, 0xD9, 0xB4, 0xA2, 0x06, 0x66, 0x8C, 0x67, 0x8C, 0x87, 0x64,
+        0x47, 0x18, 0xA2, 0x02, 0xDA, 0xB4, 0x68, 0x2C, 0x69, 0x30, 0x6A, 0x34, 0x6B, 0x01, 0xA2, 0x2A,
+        0xD8, 0xB4, 0xA2, 0x1E, 0xD9, 0xB4, 0xA2, 0x06, 0x66, 0x8C, 0x67, 0x78, 0x87, 0x65, 0x47, 0xEC,
+        0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x06, 0xA2, 0x2A, 0xD8, 0xB4, 0xA2, 0x22, 0xD9, 0xB4, 0xA2, 0x06,
+        0x66, 0xE0, 0x86, 0x6E, 0x46, 0xC0, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x0B, 0xA2, 0x2A, 0xD8, 0xB4,
+        0xA2, 0x36, 0xD9, 0xB4, 0xA2, 0x06, 0x66, 0x0F, 0x86, 0x66, 0x46, 0x07, 0xA2, 0x02, 0xDA, 0xB4,
+        0x6B, 0x10, 0xA2, 0x3A, 0xD8, 0xB4, 0xA2, 0x1E, 0xD9, 0xB4, 0xA3, 0xE8, 0x60, 0x00, 0x61, 0x30,
+        0xF1, 0x55, 0xA3, 0xE9, 0xF0, 0x65, 0xA2, 0x06, 0x40, 0x30, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x15,
+        0xA2, 0x3A, 0xD8, 0xB4, 0xA2, 0x16, 0xD9, 0xB4, 0xA3, 0xE8, 0x66, 0x89, 0xF6, 0x33, 0xF2, 0x65,
+        0xA2, 0x02, 0x30, 0x01, 0xA2, 0x06, 0x31, 0x03, 0xA2, 0x06, 0x32, 0x07, 0xA2, 0x06, 0xDA, 0xB4,
+        0x6B, 0x1A, 0xA2, 0x0E, 0xD8, 0xB4, 0xA2, 0x3E, 0xD9, 0xB4, 0x12, 0x48, 0x13, 0xDC,
+    };
+
+    static void Block_0200(Chip8State &s)
+    {
+        //  0x0200: 124E
+        s.pc = 0x024E;
+    }
+
+    static void Block_0242(Chip8State &s)
+    {
+        //  0x0242: A202
+        s.index = 0x0202;
+        s.pc = 0x0244;
+    }
+
+    static void Block_0246(Chip8State &s)
+    {
+        //  0x0246: 00EE
+        --s.sp;
+        s.pc = s.stack[s.sp & 0xF];
+    }
+
+    static void Block_0248(Chip8State &s)
+    {
+        //  0x0248: A202
+        s.index = 0x0202;
+        s.pc = 0x024A;
+    }
+
+    static void Block_024C(Chip8State &s)
+    {
+        //  0x024C: 13DC
+        s.pc = 0x03DC;
+    }
+
+    static void Block_024E(Chip8State &s)
+    {
+        //  0x024E: 6801
+        s.registers[0x8] = 0x01;
+        //  0x0250: 6905
+        s.registers[0x9] = 0x05;
+        //  0x0252: 6A0A
+        s.registers[0xA] = 0x0A;
+        //  0x0254: 6B01
+        s.registers[0xB] = 0x01;
+        //  0x0256: 652A
+        s.registers[0x5] = 0x2A;
+        //  0x0258: 662B
+        s.registers[0x6] = 0x2B;
+        //  0x025A: A216
+        s.index = 0x0216;
+        s.pc = 0x025C;
+    }
+
+    static void Block_025E(Chip8State &s)
+    {
+        //  0x025E: A23E
+        s.index = 0x023E;
+        s.pc = 0x0260;
+    }
+
+    static void Block_0262(Chip8State &s)
+    {
+        //  0x0262: A202
+        s.index = 0x0202;
+        //  0x0264: 362B
+        s.pc = (s.registers[0x6] == 0x2B) ? 0x0268 : 0x0266;
+    }
+
+    static void Block_0266(Chip8State &s)
+    {
+        //  0x0266: A206
+        s.index = 0x0206;
+        s.pc = 0x0268;
+    }
+
+    static void Block_026A(Chip8State &s)
+    {
+        //  0x026A: 6B06
+        s.registers[0xB] = 0x06;
+        //  0x026C: A21A
+        s.index = 0x021A;
+        s.pc = 0x026E;
+    }
+
+    static void Block_0270(Chip8State &s)
+    {
+        //  0x0270: A23E
+        s.index = 0x023E;
+        s.pc = 0x0272;
+    }
+
+    static void Block_0274(Chip8State &s)
+    {
+        //  0x0274: A206
+        s.index = 0x0206;
+        //  0x0276: 452A
+        s.pc = (s.registers[0x5] != 0x2A) ? 0x027A : 0x0278;
+    }
+
+    static void Block_0278(Chip8State &s)
+    {
+        //  0x0278: A202
+        s.index = 0x0202;
+        s.pc = 0x027A;
+    }
+
+    static void Block_027C(Chip8State &s)
+    {
+        //  0x027C: 6B0B
+        s.registers[0xB] = 0x0B;
+        //  0x027E: A21E
+        s.index = 0x021E;
+        s.pc = 0x0280;
+    }
+
+    static void Block_0282(Chip8State &s)
+    {
+        //  0x0282: A23E
+        s.index = 0x023E;
+        s.pc = 0x0284;
+    }
+
+    static void Block_0286(Chip8State &s)
+    {
+        //  0x0286: A206
+        s.index = 0x0206;
+        //  0x0288: 5560
+        s.pc = (s.registers[0x5] == s.registers[0x6]) ? 0x028C : 0x028A;
+    }
+
+    static void Block_028A(Chip8State &s)
+    {
+        //  0x028A: A202
+        s.index = 0x0202;
+        s.pc = 0x028C;
+    }
+
+    static void Block_028E(Chip8State &s)
+    {
+        //  0x028E: 6B10
+        s.registers[0xB] = 0x10;
+        //  0x0290: A226
+        s.index = 0x0226;
+        s.pc = 0x0292;
+    }
+
+    static void Block_0294(Chip8State &s)
+    {
+        //  0x0294: A23E
+        s.index = 0x023E;
+        s.pc = 0x0296;
+    }
+
+    static void Block_0298(Chip8State &s)
+    {
+        //  0x0298: A206
+        s.index = 0x0206;
+        //  0x029A: 76FF
+        s.registers[0x6] += 0xFF;
+        //  0x029C: 462A
+        s.pc = (s.registers[0x6] != 0x2A) ? 0x02A0 : 0x029E;
+    }
+
+    static void Block_029E(Chip8State &s)
+    {
+        //  0x029E: A202
+        s.index = 0x0202;
+        s.pc = 0x02A0;
+    }
+
+    static void Block_02A2(Chip8State &s)
+    {
+        //  0x02A2: 6B15
+        s.registers[0xB] = 0x15;
+        //  0x02A4: A22E
+        s.index = 0x022E;
+        s.pc = 0x02A6;
+    }
+
+    static void Block_02A8(Chip8State &s)
+    {
+        //  0x02A8: A23E
+        s.index = 0x023E;
+        s.pc = 0x02AA;
+    }
+
+    static void Block_02AC(Chip8State &s)
+    {
+        //  0x02AC: A206
+        s.index = 0x0206;
+        //  0x02AE: 9560
+        s.pc = (s.registers[0x5] != s.registers[0x6]) ? 0x02B2 : 0x02B0;
+    }
+
+    static void Block_02B0(Chip8State &s)
+    {
+        //  0x02B0: A202
+        s.index = 0x0202;
+        s.pc = 0x02B2;
+    }
+
+    static void Block_02B4(Chip8State &s)
+    {
+        //  0x02B4: 6B1A
+        s.registers[0xB] = 0x1A;
+        //  0x02B6: A232
+        s.index = 0x0232;
+        s.pc = 0x02B8;
+    }
+
+    static void Block_02BA(Chip8State &s)
+    {
+        //  0x02BA: A23E
+        s.index = 0x023E;
+        s.pc = 0x02BC;
+    }
+
+    static void Block_02BE(Chip8State &s)
+    {
+        //  0x02BE: 2242
+        s.stack[s.sp & 0xF] = 0x02C0;
+        ++s.sp;
+        s.pc = 0x0242;
+    }
+
+    static void Block_02C0(Chip8State &s)
+    {
+        //  0x02C0: 6817
+        s.registers[0x8] = 0x17;
+        //  0x02C2: 691B
+        s.registers[0x9] = 0x1B;
+        //  0x02C4: 6A20
+        s.registers[0xA] = 0x20;
+        //  0x02C6: 6B01
+        s.registers[0xB] = 0x01;
+        //  0x02C8: A20A
+        s.index = 0x020A;
+        s.pc = 0x02CA;
+    }
+
+    static void Block_02CC(Chip8State &s)
+    {
+        //  0x02CC: A236
+        s.index = 0x0236;
+        s.pc = 0x02CE;
+    }
+
+    static void Block_02D0(Chip8State &s)
+    {
+        //  0x02D0: A202
+        s.index = 0x0202;
+        s.pc = 0x02D2;
+    }
+
+    static void Block_02D4(Chip8State &s)
+    {
+        //  0x02D4: 6B06
+        s.registers[0xB] = 0x06;
+        //  0x02D6: A22A
+        s.index = 0x022A;
+        s.pc = 0x02D8;
+    }
+
+    static void Block_02DA(Chip8State &s)
+    {
+        //  0x02DA: A20A
+        s.index = 0x020A;
+        s.pc = 0x02DC;
+    }
+
+    static void Block_02DE(Chip8State &s)
+    {
+        //  0x02DE: A206
+        s.index = 0x0206;
+        //  0x02E0: 8750
+        s.registers[0x7] = s.registers[0x5];
+        //  0x02E2: 472A
+        s.pc = (s.registers[0x7] != 0x2A) ? 0x02E6 : 0x02E4;
+    }
+
+    static void Block_02E4(Chip8State &s)
+    {
+        //  0x02E4: A202
+        s.index = 0x0202;
+        s.pc = 0x02E6;
+    }
+
+    static void Block_02E8(Chip8State &s)
+    {
+        //  0x02E8: 6B0B
+        s.registers[0xB] = 0x0B;
+        //  0x02EA: A22A
+        s.index = 0x022A;
+        s.pc = 0x02EC;
+    }
+
+    static void Block_02EE(Chip8State &s)
+    {
+        //  0x02EE: A20E
+        s.index = 0x020E;
+        s.pc = 0x02F0;
+    }
+
+    static void Block_02F2(Chip8State &s)
+    {
+        //  0x02F2: A206
+        s.index = 0x0206;
+        //  0x02F4: 672A
+        s.registers[0x7] = 0x2A;
+        //  0x02F6: 87B1
+        s.registers[0x7] |= s.registers[0xB];
+        //  0x02F8: 472B
+        s.pc = (s.registers[0x7] != 0x2B) ? 0x02FC : 0x02FA;
+    }
+
+    static void Block_02FA(Chip8State &s)
+    {
+        //  0x02FA: A202
+        s.index = 0x0202;
+        s.pc = 0x02FC;
+    }
+
+    static void Block_02FE(Chip8State &s)
+    {
+        //  0x02FE: 6B10
+        s.registers[0xB] = 0x10;
+        //  0x0300: A22A
+        s.index = 0x022A;
+        s.pc = 0x0302;
+    }
+
+    static void Block_0304(Chip8State &s)
+    {
+        //  0x0304: A212
+        s.index = 0x0212;
+        s.pc = 0x0306;
+    }
+
+    static void Block_0308(Chip8State &s)
+    {
+        //  0x0308: A206
+        s.index = 0x0206;
+        //  0x030A: 6678
+        s.registers[0x6] = 0x78;
+        //  0x030C: 671F
+        s.registers[0x7] = 0x1F;
+        //  0x030E: 8762
+        s.registers[0x7] &= s.registers[0x6];
+        //  0x0310: 4718
+        s.pc = (s.registers[0x7] != 0x18) ? 0x0314 : 0x0312;
+    }
+
+    static void Block_0312(Chip8State &s)
+    {
+        //  0x0312: A202
+        s.index = 0x0202;
+        s.pc = 0x0314;
+    }
+
+    static void Block_0316(Chip8State &s)
+    {
+        //  0x0316: 6B15
+        s.registers[0xB] = 0x15;
+        //  0x0318: A22A
+        s.index = 0x022A;
+        s.pc = 0x031A;
+    }
+
+    static void Block_031C(Chip8State &s)
+    {
+        //  0x031C: A216
+        s.index = 0x0216;
+        s.pc = 0x031E;
+    }
+
+    static void Block_0320(Chip8State &s)
+    {
+        //  0x0320: A206
+        s.index = 0x0206;
+        //  0x0322: 6678
+        s.registers[0x6] = 0x78;
+        //  0x0324: 671F
+        s.registers[0x7] = 0x1F;
+        //  0x0326: 8763
+        s.registers[0x7] ^= s.registers[0x6];
+        //  0x0328: 4767
+        s.pc = (s.registers[0x7] != 0x67) ? 0x032C : 0x032A;
+    }
+
+    static void Block_032A(Chip8State &s)
+    {
+        //  0x032A: A202
+        s.index = 0x0202;
+        s.pc = 0x032C;
+    }
+
+    static void Block_032E(Chip8State &s)
+    {
+        //  0x032E: 6B1A
+        s.registers[0xB] = 0x1A;
+        //  0x0330: A22A
+        s.index = 0x022A;
+        s.pc = 0x0332;
+    }
+
+    static void Block_0334(Chip8State &s)
+    {
+        //  0x0334: A21A
+        s.index = 0x021A;
+        s.pc = 0x0336;
+    }
+
+    static void Block_0338(Chip8State &s)
+    {
+        //  0x0338: A206
+        s.index = 0x0206;
+        //  0x033A: 668C
+        s.registers[0x6] = 0x8C;
+        //  0x033C: 678C
+        s.registers[0x7] = 0x8C;
+        //  0x033E: 8764
+        {
+            uint16_t sum = s.registers[0x7] + s.registers[0x6];
+            s.registers[0xF] = (sum > UINT8_MAX);
+            s.registers[0x7] = sum & 0xFFu;
+        }
+        //  0x0340: 4718
+        s.pc = (s.registers[0x7] != 0x18) ? 0x0344 : 0x0342;
+    }
+
+    static void Block_0342(Chip8State &s)
+    {
+        //  0x0342: A202
+        s.index = 0x0202;
+        s.pc = 0x0344;
+    }
+
+    static void Block_0346(Chip8State &s)
+    {
+        //  0x0346: 682C
+        s.registers[0x8] = 0x2C;
+        //  0x0348: 6930
+        s.registers[0x9] = 0x30;
+        //  0x034A: 6A34
+        s.registers[0xA] = 0x34;
+        //  0x034C: 6B01
+        s.registers[0xB] = 0x01;
+        //  0x034E: A22A
+        s.index = 0x022A;
+        s.pc = 0x0350;
+    }
+
+    static void Block_0352(Chip8State &s)
+    {
+        //  0x0352: A21E
+        s.index = 0x021E;
+        s.pc = 0x0354;
+    }
+
+    static void Block_0356(Chip8State &s)
+    {
+        //  0x0356: A206
+        s.index = 0x0206;
+        //  0x0358: 668C
+        s.registers[0x6] = 0x8C;
+        //  0x035A: 6778
+        s.registers[0x7] = 0x78;
+        //  0x035C: 8765
+        s.registers[0xF] = (s.registers[0x7] > s.registers[0x6]);
+        s.registers[0x7] -= s.registers[0x6];
+        //  0x035E: 47EC
+        s.pc = (s.registers[0x7] != 0xEC) ? 0x0362 : 0x0360;
+    }
+
+    static void Block_0360(Chip8State &s)
+    {
+        //  0x0360: A202
+        s.index = 0x0202;
+        s.pc = 0x0362;
+    }
+
+    static void Block_0364(Chip8State &s)
+    {
+        //  0x0364: 6B06
+        s.registers[0xB] = 0x06;
+        //  0x0366: A22A
+        s.index = 0x022A;
+        s.pc = 0x0368;
+    }
+
+    static void Block_036A(Chip8State &s)
+    {
+        //  0x036A: A222
+        s.index = 0x0222;
+        s.pc = 0x036C;
+    }
+
+    static void Block_036E(Chip8State &s)
+    {
+        //  0x036E: A206
+        s.index = 0x0206;
+        //  0x0370: 66E0
+        s.registers[0x6] = 0xE0;
+        //  0x0372: 866E
+        s.registers[0xF] = (s.registers[0x6] & 0x80u) >> 0x7u;
+        s.registers[0x6] <<= 1;
+        //  0x0374: 46C0
+        s.pc = (s.registers[0x6] != 0xC0) ? 0x0378 : 0x0376;
+    }
+
+    static void Block_0376(Chip8State &s)
+    {
+        //  0x0376: A202
+        s.index = 0x0202;
+        s.pc = 0x0378;
+    }
+
+    static void Block_037A(Chip8State &s)
+    {
+        //  0x037A: 6B0B
+        s.registers[0xB] = 0x0B;
+        //  0x037C: A22A
+        s.index = 0x022A;
+        s.pc = 0x037E;
+    }
+
+    static void Block_0380(Chip8State &s)
+    {
+        //  0x0380: A236
+        s.index = 0x0236;
+        s.pc = 0x0382;
+    }
+
+    static void Block_0384(Chip8State &s)
+    {
+        //  0x0384: A206
+        s.index = 0x0206;
+        //  0x0386: 660F
+        s.registers[0x6] = 0x0F;
+        //  0x0388: 8666
+        s.registers[0xF] = (s.registers[0x6] & 0x1u);
+        s.registers[0x6] >>= 1;
+        //  0x038A: 4607
+        s.pc = (s.registers[0x6] != 0x07) ? 0x038E : 0x038C;
+    }
+
+    static void Block_038C(Chip8State &s)
+    {
+        //  0x038C: A202
+        s.index = 0x0202;
+        s.pc = 0x038E;
+    }
+
+    static void Block_0390(Chip8State &s)
+    {
+        //  0x0390: 6B10
+        s.registers[0xB] = 0x10;
+        //  0x0392: A23A
+        s.index = 0x023A;
+        s.pc = 0x0394;
+    }
+
+    static void Block_0396(Chip8State &s)
+    {
+        //  0x0396: A21E
+        s.index = 0x021E;
+        s.pc = 0x0398;
+    }
+
+    static void Block_039A(Chip8State &s)
+    {
+        //  0x039A: A3E8
+        s.index = 0x03E8;
+        //  0x039C: 6000
+        s.registers[0x0] = 0x00;
+        //  0x039E: 6130
+        s.registers[0x1] = 0x30;
+        s.pc = 0x03A0;
+    }
+
+    static void Block_03A2(Chip8State &s)
+    {
+        //  0x03A2: A3E9
+        s.index = 0x03E9;
+        //  0x03A4: F065
+        //  0x03A6: A206
+        s.index = 0x0206;
+        //  0x03A8: 4030
+        s.pc = (s.registers[0x0] != 0x30) ? 0x03AC : 0x03AA;
+    }
+
+    static void Block_03AA(Chip8State &s)
+    {
+        //  0x03AA: A202
+        s.index = 0x0202;
+        s.pc = 0x03AC;
+    }
+
+    static void Block_03AE(Chip8State &s)
+    {
+        //  0x03AE: 6B15
+        s.registers[0xB] = 0x15;
+        //  0x03B0: A23A
+        s.index = 0x023A;
+        s.pc = 0x03B2;
+    }
+
+    static void Block_03B4(Chip8State &s)
+    {
+        //  0x03B4: A216
+        s.index = 0x0216;
+        s.pc = 0x03B6;
+    }
+
+    static void Block_03B8(Chip8State &s)
+    {
+        //  0x03B8: A3E8
+        s.index = 0x03E8;
+        //  0x03BA: 6689
+        s.registers[0x6] = 0x89;
+        s.pc = 0x03BC;
+    }
+
+    static void Block_03BE(Chip8State &s)
+    {
+        //  0x03BE: F265
+        for (size_t i = 0; i < 0x2; i++)
+        {
+            s.registers[i] = s.memory[(s.index + i) & 0xFFF];
+        }
+        //  0x03C0: A202
+        s.index = 0x0202;
+        //  0x03C2: 3001
+        s.pc = (s.registers[0x0] == 0x01) ? 0x03C6 : 0x03C4;
+    }
+
+    static void Block_03C4(Chip8State &s)
+    {
+        //  0x03C4: A206
+        s.index = 0x0206;
+        //  0x03C6: 3103
+        s.pc = (s.registers[0x1] == 0x03) ? 0x03CA : 0x03C8;
+    }
+
+    static void Block_03C6(Chip8State &s)
+    {
+        //  0x03C6: 3103
+        s.pc = (s.registers[0x1] == 0x03) ? 0x03CA : 0x03C8;
+    }
+
+    static void Block_03C8(Chip8State &s)
+    {
+        //  0x03C8: A206
+        s.index = 0x0206;
+        //  0x03CA: 3207
+        s.pc = (s.registers[0x2] == 0x07) ? 0x03CE : 0x03CC;
+    }
+
+    static void Block_03CA(Chip8State &s)
+    {
+        //  0x03CA: 3207
+        s.pc = (s.registers[0x2] == 0x07) ? 0x03CE : 0x03CC;
+    }
+
+    static void Block_03CC(Chip8State &s)
+    {
+        //  0x03CC: A206
+        s.index = 0x0206;
+        s.pc = 0x03CE;
+    }
+
+    static void Block_03D0(Chip8State &s)
+    {
+        //  0x03D0: 6B1A
+        s.registers[0xB] = 0x1A;
+        //  0x03D2: A20E
+        s.index = 0x020E;
+        s.pc = 0x03D4;
+    }
+
+    static void Block_03D6(Chip8State &s)
+    {
+        //  0x03D6: A23E
+        s.index = 0x023E;
+        s.pc = 0x03D8;
+    }
+
+    static void Block_03DA(Chip8State &s)
+    {
+        //  0x03DA: 1248
+        s.pc = 0x0248;
+    }
+
+    static void Block_03DC(Chip8State &s)
+    {
+        //  0x03DC: 13DC
+        s.pc = 0x03DC;
+    }
+
+    const Chip8AOTBlock blocks[] = {
+        {0x0200, 1, &Block_0200},
+        {0x0242, 1, &Block_0242},
+        {0x0246, 1, &Block_0246},
+        {0x0248, 1, &Block_0248},
+        {0x024C, 1, &Block_024C},
+        {0x024E, 7, &Block_024E},
+        {0x025E, 1, &Block_025E},
+        {0x0262, 2, &Block_0262},
+        {0x0266, 1, &Block_0266},
+        {0x026A, 2, &Block_026A},
+        {0x0270, 1, &Block_0270},
+        {0x0274, 2, &Block_0274},
+        {0x0278, 1, &Block_0278},
+        {0x027C, 2, &Block_027C},
+        {0x0282, 1, &Block_0282},
+        {0x0286, 2, &Block_0286},
+        {0x028A, 1, &Block_028A},
+        {0x028E, 2, &Block_028E},
+        {0x0294, 1, &Block_0294},
+        {0x0298, 3, &Block_0298},
+        {0x029E, 1, &Block_029E},
+        {0x02A2, 2, &Block_02A2},
+        {0x02A8, 1, &Block_02A8},
+        {0x02AC, 2, &Block_02AC},
+        {0x02B0, 1, &Block_02B0},
+        {0x02B4, 2, &Block_02B4},
+        {0x02BA, 1, &Block_02BA},
+        {0x02BE, 1, &Block_02BE},
+        {0x02C0, 5, &Block_02C0},
+        {0x02CC, 1, &Block_02CC},
+        {0x02D0, 1, &Block_02D0},
+        {0x02D4, 2, &Block_02D4},
+        {0x02DA, 1, &Block_02DA},
+        {0x02DE, 3, &Block_02DE},
+        {0x02E4, 1, &Block_02E4},
+        {0x02E8, 2, &Block_02E8},
+        {0x02EE, 1, &Block_02EE},
+        {0x02F2, 4, &Block_02F2},
+        {0x02FA, 1, &Block_02FA},
+        {0x02FE, 2, &Block_02FE},
+        {0x0304, 1, &Block_0304},
+        {0x0308, 5, &Block_0308},
+        {0x0312, 1, &Block_0312},
+        {0x0316, 2, &Block_0316},
+        {0x031C, 1, &Block_031C},
+        {0x0320, 5, &Block_0320},
+        {0x032A, 1, &Block_032A},
+        {0x032E, 2, &Block_032E},
+        {0x0334, 1, &Block_0334},
+        {0x0338, 5, &Block_0338},
+        {0x0342, 1, &Block_0342},
+        {0x0346, 5, &Block_0346},
+        {0x0352, 1, &Block_0352},
+        {0x0356, 5, &Block_0356},
+        {0x0360, 1, &Block_0360},
+        {0x0364, 2, &Block_0364},
+        {0x036A, 1, &Block_036A},
+        {0x036E, 4, &Block_036E},
+        {0x0376, 1, &Block_0376},
+        {0x037A, 2, &Block_037A},
+        {0x0380, 1, &Block_0380},
+        {0x0384, 4, &Block_0384},
+        {0x038C, 1, &Block_038C},
+        {0x0390, 2, &Block_0390},
+        {0x0396, 1, &Block_0396},
+        {0x039A, 3, &Block_039A},
+        {0x03A2, 4, &Block_03A2},
+        {0x03AA, 1, &Block_03AA},
+        {0x03AE, 2, &Block_03AE},
+        {0x03B4, 1, &Block_03B4},
+        {0x03B8, 2, &Block_03B8},
+        {0x03BE, 3, &Block_03BE},
+        {0x03C4, 2, &Block_03C4},
+        {0x03C6, 1, &Block_03C6},
+        {0x03C8, 2, &Block_03C8},
+        {0x03CA, 1, &Block_03CA},
+        {0x03CC, 1, &Block_03CC},
+        {0x03D0, 2, &Block_03D0},
+        {0x03D6, 1, &Block_03D6},
+        {0x03DA, 1, &Block_03DA},
+        {0x03DC, 1, &Block_03DC},
+    };
+
+    const Chip8AOTProgram program = {"UnitTests/test_opcode.ch8", rom, sizeof(rom), blocks, sizeof(blocks) / sizeof(blocks[0])};
+
+    const bool registered = Chip8AOT::Register(program);
+}
+
+//  UnitTests/SelfModifyingCode: 8 blocks, 15 instructions.
+namespace Recompiled1
+{
+    const uint8_t rom[] = {
+        0x64, 0x00, 0xA2, 0x50, 0x34, 0x01, 0x12, 0x0A, 0x12, 0x1A, 0x74, 0x01, 0x60, 0xA2, 0x61, 0x40,
+        0x62, 0x34, 0xA2, 0x02, 0xF2, 0x55, 0x12, 0x02, 0x00, 0x00, 0x65, 0x00, 0xD5, 0x51, 0x12, 0x1E,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    static void Block_0200(Chip8State &s)
+    {
+        //  0x0200: 6400
+        s.registers[0x4] = 0x00;
+        //  0x0202: A250
+        s.index = 0x0250;
+        //  0x0204: 3401
+        s.pc = (s.registers[0x4] == 0x01) ? 0x0208 : 0x0206;
+    }
+
+    static void Block_0202(Chip8State &s)
+    {
+        //  0x0202: A250
+        s.index = 0x0250;
+        //  0x0204: 3401
+        s.pc = (s.registers[0x4] == 0x01) ? 0x0208 : 0x0206;
+    }
+
+    static void Block_0206(Chip8State &s)
+    {
+        //  0x0206: 120A
+        s.pc = 0x020A;
+    }
+
+    static void Block_0208(Chip8State &s)
+    {
+        //  0x0208: 121A
+        s.pc = 0x021A;
+    }
+
+    static void Block_020A(Chip8State &s)
+    {
+        //  0x020A: 7401
+        s.registers[0x4] += 0x01;
+        //  0x020C: 60A2
+        s.registers[0x0] = 0xA2;
+        //  0x020E: 6140
+        s.registers[0x1] = 0x40;
+        //  0x0210: 6234
+        s.registers[0x2] = 0x34;
+        //  0x0212: A202
+        s.index = 0x0202;
+        s.pc = 0x0214;
+    }
+
+    static void Block_0216(Chip8State &s)
+    {
+        //  0x0216: 1202
+        s.pc = 0x0202;
+    }
+
+    static void Block_021A(Chip8State &s)
+    {
+        //  0x021A: 6500
+        s.registers[0x5] = 0x00;
+        s.pc = 0x021C;
+    }
+
+    static void Block_021E(Chip8State &s)
+    {
+        //  0x021E: 121E
+        s.pc = 0x021E;
+    }
+
+    const Chip8AOTBlock blocks[] = {
+        {0x0200, 3, &Block_0200},
+        {0x0202, 2, &Block_0202},
+        {0x0206, 1, &Block_0206},
+        {0x0208, 1, &Block_0208},
+        {0x020A, 5, &Block_020A},
+        {0x0216, 1, &Block_0216},
+        {0x021A, 1, &Block_021A},
+        {0x021E, 1, &Block_021E},
+    };
+
+    const Chip8AOTProgram program = {"UnitTests/SelfModifyingCode", rom, sizeof(rom), blocks, sizeof(blocks) / sizeof(blocks[0])};
+
+    const bool registered = Chip8AOT::Register(program);
+}
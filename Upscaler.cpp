@@ -0,0 +1,445 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "Upscaler.h"
+#include <cstring>
+#include <stdexcept>
+
+//  SSE2 is part of every x86-64 CPU, so its kernels are picked whenever the compiler targets it.
+#if defined(__SSE2__)
+#define CHIP8_UPSCALER_SSE2 1
+#include <emmintrin.h>
+#else
+#define CHIP8_UPSCALER_SSE2 0
+#endif
+
+//  The AVX2 kernel is compiled for x86 hosts only, and picked at runtime when the CPU supports it.
+#if CHIP8_UPSCALER_SSE2 && (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CHIP8_UPSCALER_AVX2 1
+#define AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#else
+#define CHIP8_UPSCALER_AVX2 0
+#endif
+
+//  A gray level in every byte of a pixel, so lit pixels have all bits set as `ExpandRows` writes them.
+static uint32_t GrayPixel(uint8_t gray)
+{
+    return gray * 0x01010101u;
+}
+
+/***
+ *  Upscaler:
+ *      Constructor, allocates the buffers of the stages, every pixel starting dark.
+ *
+ *  @param scale        The output pixels per screen pixel, in each direction.
+ *  @param filter       The scaling filter.
+ *  @param persistence  How much of its brightness a pixel turned off keeps each frame, out of 256.
+ *  @param vectorized   Whether the SIMD kernels run, when the host has them.
+ ***/
+Upscaler::Upscaler(uint32_t scale, ScaleFilter filter, uint8_t persistence, bool vectorized)
+    : scale(scale),
+      filter(filter),
+      persistence(persistence),
+      vectorized(vectorized && CHIP8_UPSCALER_SSE2),
+      intensity(Chip8Constants::VIDEO_WIDTH * Chip8Constants::VIDEO_HEIGHT, 0),
+      source(UpscalerConstants::PADDED_WIDTH * UpscalerConstants::PADDED_HEIGHT, 0)
+{
+    if (scale == 0 || (filter == ScaleFilter::Scale2x && scale % 2 != 0))
+    {
+        throw std::invalid_argument("The scale is 0, or odd with Scale2x.");
+    }
+
+    if (filter == ScaleFilter::Scale2x)
+    {
+        this->doubled.assign(4 * Chip8Constants::VIDEO_WIDTH * Chip8Constants::VIDEO_HEIGHT, 0);
+    }
+
+#if CHIP8_UPSCALER_AVX2
+    this->useAVX2 = this->vectorized && __builtin_cpu_supports("avx2");
+#endif
+}
+
+/***
+ *  Render:
+ *      Expands the screen into gray pixels, fading the pixels turned off, then scales it into the buffer.
+ *
+ *  @param video    The bit packed screen.
+ *  @param pixels   The buffer to write, `OutputWidth` by `OutputHeight` pixels.
+ *  @param pitch    The number of bytes in a row of the buffer.
+ ***/
+void Upscaler::Render(const uint64_t *video, uint32_t *pixels, size_t pitch)
+{
+    this->ExpandSource(video);
+
+    if (this->filter == ScaleFilter::Nearest)
+    {
+        this->Nearest(this->source.data() + UpscalerConstants::PADDED_WIDTH + 1,
+                      UpscalerConstants::PADDED_WIDTH,
+                      Chip8Constants::VIDEO_WIDTH,
+                      Chip8Constants::VIDEO_HEIGHT,
+                      this->scale,
+                      pixels,
+                      pitch);
+        return;
+    }
+
+    this->PadSource();
+
+#if CHIP8_UPSCALER_SSE2
+    if (this->vectorized)
+    {
+        this->Scale2xSSE2();
+    }
+    else
+#endif
+    {
+        this->Scale2xScalar();
+    }
+
+    this->Nearest(this->doubled.data(),
+                  2 * Chip8Constants::VIDEO_WIDTH,
+                  2 * Chip8Constants::VIDEO_WIDTH,
+                  2 * Chip8Constants::VIDEO_HEIGHT,
+                  this->scale / 2,
+                  pixels,
+                  pitch);
+}
+
+bool Upscaler::Fading() const
+{
+    for (uint8_t level : this->intensity)
+    {
+        if (level != 0 && level != 0xFF)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Upscaler::ExpandSource(const uint64_t *video)
+{
+#if CHIP8_UPSCALER_SSE2
+    if (this->vectorized)
+    {
+        this->ExpandSourceSSE2(video);
+        return;
+    }
+#endif
+
+    this->ExpandSourceScalar(video);
+}
+
+/***
+ *  ExpandSourceScalar:
+ *      Lights the pixels which are on fully, and fades the others by the persistence.
+ *      Without persistence the pixels which are off are dark at once.
+ *
+ *  @param video    The bit packed screen.
+ ***/
+void Upscaler::ExpandSourceScalar(const uint64_t *video)
+{
+    for (size_t row = 0; row < Chip8Constants::VIDEO_HEIGHT; row++)
+    {
+        uint32_t *sourceRow = this->source.data() + (row + 1) * UpscalerConstants::PADDED_WIDTH + 1;
+        uint8_t *levels = this->intensity.data() + row * Chip8Constants::VIDEO_WIDTH;
+
+        for (size_t column = 0; column < Chip8Constants::VIDEO_WIDTH; column++)
+        {
+            bool on = (video[row] >> (Chip8Constants::VIDEO_WIDTH - 1 - column)) & 1u;
+
+            levels[column] = on ? 0xFF : (levels[column] * this->persistence) >> 8;
+            sourceRow[column] = GrayPixel(levels[column]);
+        }
+    }
+}
+
+#if CHIP8_UPSCALER_SSE2
+/***
+ *  ExpandSourceSSE2:
+ *      Does what `ExpandSourceScalar` does 16 pixels at a time: the bits become bytes by testing
+ *      a repeated byte against a mask per position, the fade multiplies 16 bit lanes,
+ *      and unpacking the bytes with themselves turns them into gray pixels.
+ *
+ *  @param video    The bit packed screen.
+ ***/
+void Upscaler::ExpandSourceSSE2(const uint64_t *video)
+{
+    const __m128i positions = _mm_setr_epi8(char(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                            char(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    const __m128i persistence = _mm_set1_epi16(this->persistence);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (size_t row = 0; row < Chip8Constants::VIDEO_HEIGHT; row++)
+    {
+        uint32_t *sourceRow = this->source.data() + (row + 1) * UpscalerConstants::PADDED_WIDTH + 1;
+        uint8_t *levels = this->intensity.data() + row * Chip8Constants::VIDEO_WIDTH;
+
+        for (size_t column = 0; column < Chip8Constants::VIDEO_WIDTH; column += 16)
+        {
+            uint8_t left = video[row] >> (56 - column);
+            uint8_t right = video[row] >> (48 - column);
+            __m128i bits = _mm_set_epi64x(right * 0x0101010101010101ull, left * 0x0101010101010101ull);
+            __m128i on = _mm_cmpeq_epi8(_mm_and_si128(bits, positions), positions);
+
+            __m128i old = _mm_loadu_si128(reinterpret_cast<const __m128i *>(levels + column));
+            __m128i low = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(old, zero), persistence), 8);
+            __m128i high = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(old, zero), persistence), 8);
+            __m128i gray = _mm_or_si128(on, _mm_packus_epi16(low, high));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(levels + column), gray);
+
+            __m128i grayLow = _mm_unpacklo_epi8(gray, gray);
+            __m128i grayHigh = _mm_unpackhi_epi8(gray, gray);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(sourceRow + column), _mm_unpacklo_epi16(grayLow, grayLow));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(sourceRow + column + 4), _mm_unpackhi_epi16(grayLow, grayLow));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(sourceRow + column + 8), _mm_unpacklo_epi16(grayHigh, grayHigh));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(sourceRow + column + 12), _mm_unpackhi_epi16(grayHigh, grayHigh));
+        }
+    }
+}
+#endif
+
+//  Repeats the edge pixels into the border, so the edges have neighbours equal to themselves.
+void Upscaler::PadSource()
+{
+    uint32_t *source = this->source.data();
+    const size_t width = UpscalerConstants::PADDED_WIDTH;
+
+    for (size_t row = 1; row <= Chip8Constants::VIDEO_HEIGHT; row++)
+    {
+        source[row * width] = source[row * width + 1];
+        source[row * width + width - 1] = source[row * width + width - 2];
+    }
+
+    memcpy(source, source + width, width * sizeof(source[0]));
+    memcpy(source + (UpscalerConstants::PADDED_HEIGHT - 1) * width,
+           source + (UpscalerConstants::PADDED_HEIGHT - 2) * width,
+           width * sizeof(source[0]));
+}
+
+/***
+ *  Scale2xScalar:
+ *      Turns every pixel into 4, each taking the color of the two neighbours it touches
+ *      when they are equal and the other two neighbours differ from them.
+ ***/
+void Upscaler::Scale2xScalar()
+{
+    const size_t width = UpscalerConstants::PADDED_WIDTH;
+    const size_t outputWidth = 2 * Chip8Constants::VIDEO_WIDTH;
+
+    for (size_t row = 0; row < Chip8Constants::VIDEO_HEIGHT; row++)
+    {
+        const uint32_t *center = this->source.data() + (row + 1) * width + 1;
+        uint32_t *top = this->doubled.data() + 2 * row * outputWidth;
+        uint32_t *bottom = top + outputWidth;
+
+        for (size_t column = 0; column < Chip8Constants::VIDEO_WIDTH; column++)
+        {
+            uint32_t P = center[column];
+            uint32_t A = center[column - width];
+            uint32_t B = center[column + 1];
+            uint32_t C = center[column - 1];
+            uint32_t D = center[column + width];
+
+            top[2 * column] = (C == A && C != D && A != B) ? A : P;
+            top[2 * column + 1] = (A == B && A != C && B != D) ? B : P;
+            bottom[2 * column] = (D == C && D != B && C != A) ? C : P;
+            bottom[2 * column + 1] = (B == D && B != A && D != C) ? D : P;
+        }
+    }
+}
+
+#if CHIP8_UPSCALER_SSE2
+//  Picks `value` where the mask is set, and `otherwise` elsewhere.
+static __m128i Select(__m128i mask, __m128i value, __m128i otherwise)
+{
+    return _mm_or_si128(_mm_and_si128(mask, value), _mm_andnot_si128(mask, otherwise));
+}
+
+/***
+ *  Scale2xSSE2:
+ *      Does what `Scale2xScalar` does 4 pixels at a time, interleaving the left and right
+ *      output pixels of each row with unpacks.
+ ***/
+void Upscaler::Scale2xSSE2()
+{
+    const size_t width = UpscalerConstants::PADDED_WIDTH;
+    const size_t outputWidth = 2 * Chip8Constants::VIDEO_WIDTH;
+
+    for (size_t row = 0; row < Chip8Constants::VIDEO_HEIGHT; row++)
+    {
+        const uint32_t *center = this->source.data() + (row + 1) * width + 1;
+        uint32_t *top = this->doubled.data() + 2 * row * outputWidth;
+        uint32_t *bottom = top + outputWidth;
+
+        for (size_t column = 0; column < Chip8Constants::VIDEO_WIDTH; column += 4)
+        {
+            __m128i P = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center + column));
+            __m128i A = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center + column - width));
+            __m128i B = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center + column + 1));
+            __m128i C = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center + column - 1));
+            __m128i D = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center + column + width));
+
+            __m128i CA = _mm_cmpeq_epi32(C, A);
+            __m128i AB = _mm_cmpeq_epi32(A, B);
+            __m128i DC = _mm_cmpeq_epi32(D, C);
+            __m128i BD = _mm_cmpeq_epi32(B, D);
+
+            __m128i topLeft = Select(_mm_andnot_si128(_mm_or_si128(DC, AB), CA), A, P);
+            __m128i topRight = Select(_mm_andnot_si128(_mm_or_si128(CA, BD), AB), B, P);
+            __m128i bottomLeft = Select(_mm_andnot_si128(_mm_or_si128(BD, CA), DC), C, P);
+            __m128i bottomRight = Select(_mm_andnot_si128(_mm_or_si128(AB, DC), BD), D, P);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(top + 2 * column), _mm_unpacklo_epi32(topLeft, topRight));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(top + 2 * column + 4), _mm_unpackhi_epi32(topLeft, topRight));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(bottom + 2 * column), _mm_unpacklo_epi32(bottomLeft, bottomRight));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(bottom + 2 * column + 4), _mm_unpackhi_epi32(bottomLeft, bottomRight));
+        }
+    }
+}
+#endif
+
+/***
+ *  Nearest:
+ *      Widens each row of the image once, then copies the widened row into the rows below it.
+ *
+ *  @param image    The first pixel of the image.
+ *  @param stride   The amount of pixels between the rows of the image.
+ *  @param width    The width of the image.
+ *  @param height   The height of the image.
+ *  @param factor   The output pixels per image pixel, in each direction.
+ *  @param pixels   The buffer to write.
+ *  @param pitch    The number of bytes in a row of the buffer.
+ ***/
+void Upscaler::Nearest(const uint32_t *image, size_t stride, size_t width, size_t height, uint32_t factor, uint32_t *pixels, size_t pitch) const
+{
+    //  Picking the widest kernel once per frame.
+    void (*widen)(const uint32_t *, size_t, uint32_t, uint32_t *) = &Upscaler::NearestRowScalar;
+
+#if CHIP8_UPSCALER_SSE2
+    if (this->vectorized)
+    {
+        widen = &Upscaler::NearestRowSSE2;
+    }
+#endif
+
+#if CHIP8_UPSCALER_AVX2
+    if (this->useAVX2)
+    {
+        widen = &Upscaler::NearestRowAVX2;
+    }
+#endif
+
+    for (size_t row = 0; row < height; row++)
+    {
+        uint8_t *first = reinterpret_cast<uint8_t *>(pixels) + row * factor * pitch;
+
+        widen(image + row * stride, width, factor, reinterpret_cast<uint32_t *>(first));
+
+        for (uint32_t copy = 1; copy < factor; copy++)
+        {
+            memcpy(first + copy * pitch, first, width * factor * sizeof(uint32_t));
+        }
+    }
+}
+
+void Upscaler::NearestRowScalar(const uint32_t *row, size_t width, uint32_t factor, uint32_t *output)
+{
+    for (size_t column = 0; column < width; column++)
+    {
+        for (uint32_t copy = 0; copy < factor; copy++)
+        {
+            output[column * factor + copy] = row[column];
+        }
+    }
+}
+
+#if CHIP8_UPSCALER_SSE2
+/***
+ *  NearestRowSSE2:
+ *      Stores each pixel 4 times at once. A pixel repeated more than 4 times ends with a store
+ *      overlapping its previous one, and a pixel repeated fewer times is partly overwritten by
+ *      the next pixel, so no pixel needs a scalar tail but the last one.
+ *      Doubling interleaves 4 pixels with themselves, and a factor of 1 is a copy.
+ *
+ *  @param row      The pixels of the image row.
+ *  @param width    The amount of pixels in the row.
+ *  @param factor   The times each pixel is repeated.
+ *  @param output   The widened row.
+ ***/
+void Upscaler::NearestRowSSE2(const uint32_t *row, size_t width, uint32_t factor, uint32_t *output)
+{
+    if (factor == 2)
+    {
+        for (size_t column = 0; column < width; column += 4)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + column));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 2 * column), _mm_unpacklo_epi32(pixels, pixels));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 2 * column + 4), _mm_unpackhi_epi32(pixels, pixels));
+        }
+
+        return;
+    }
+
+    if (factor == 1)
+    {
+        memcpy(output, row, width * sizeof(uint32_t));
+        return;
+    }
+
+    if (factor < 4)
+    {
+        for (size_t column = 0; column + 1 < width; column++)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(output + column * factor), _mm_set1_epi32(row[column]));
+        }
+
+        NearestRowScalar(row + width - 1, 1, factor, output + (width - 1) * factor);
+
+        return;
+    }
+
+    for (size_t column = 0; column < width; column++)
+    {
+        __m128i pixel = _mm_set1_epi32(row[column]);
+        uint32_t *span = output + column * factor;
+
+        for (uint32_t copy = 0; copy + 4 < factor; copy += 4)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(span + copy), pixel);
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(span + factor - 4), pixel);
+    }
+}
+#endif
+
+#if CHIP8_UPSCALER_AVX2
+//  `NearestRowSSE2` with 8 pixels per store, the SSE2 kernel widens rows by less than 8.
+AVX2_TARGET void Upscaler::NearestRowAVX2(const uint32_t *row, size_t width, uint32_t factor, uint32_t *output)
+{
+    if (factor < 8)
+    {
+        NearestRowSSE2(row, width, factor, output);
+        return;
+    }
+
+    for (size_t column = 0; column < width; column++)
+    {
+        __m256i pixel = _mm256_set1_epi32(row[column]);
+        uint32_t *span = output + column * factor;
+
+        for (uint32_t copy = 0; copy + 8 < factor; copy += 8)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(span + copy), pixel);
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(span + factor - 8), pixel);
+    }
+}
+#endif
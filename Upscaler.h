@@ -0,0 +1,77 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include "Chip8.h"
+#include <vector>
+
+namespace UpscalerConstants
+{
+    //  The screen with a pixel of border on every side, the border repeating the edge pixels for Scale2x.
+    constexpr size_t PADDED_WIDTH = Chip8Constants::VIDEO_WIDTH + 2;
+    constexpr size_t PADDED_HEIGHT = Chip8Constants::VIDEO_HEIGHT + 2;
+
+    //  The persistence keeping no trail, every pixel takes its new value at once.
+    constexpr uint8_t NO_PERSISTENCE = 0;
+};
+
+enum class ScaleFilter
+{
+    //  Every pixel becomes a square of `scale` by `scale` pixels.
+    Nearest,
+
+    //  The screen is doubled with Scale2x (EPX), rounding the diagonal edges, then scaled by half the scale.
+    Scale2x
+};
+
+//  Renders the bit packed screen into a 32 bit pixel buffer of the window size on the CPU,
+//  for hosts whose renderer would stretch the texture in software.
+//  Every frame costs the same: the whole screen is expanded, blended and scaled each time.
+//  The kernels use SSE2, and AVX2 for the scaling when the CPU supports it, with portable versions for other hosts.
+class Upscaler
+{
+private:
+    uint32_t scale;
+    ScaleFilter filter;
+    uint8_t persistence;
+    bool vectorized;
+    bool useAVX2{false};
+
+    //  The brightness of each pixel, lit pixels fade by `persistence / 256` every frame instead of turning off.
+    std::vector<uint8_t> intensity;
+
+    //  The gray pixels of the screen with their border, and the Scale2x output.
+    std::vector<uint32_t> source;
+    std::vector<uint32_t> doubled;
+
+    //  Turns the screen into gray pixels inside the border, fading the pixels turned off.
+    void ExpandSource(const uint64_t *video);
+    void ExpandSourceScalar(const uint64_t *video);
+    void ExpandSourceSSE2(const uint64_t *video);
+    void PadSource();
+
+    //  Doubles the padded source into `doubled`.
+    void Scale2xScalar();
+    void Scale2xSSE2();
+
+    //  Repeats every pixel of an image `factor` times in both directions.
+    void Nearest(const uint32_t *image, size_t stride, size_t width, size_t height, uint32_t factor, uint32_t *pixels, size_t pitch) const;
+    static void NearestRowScalar(const uint32_t *row, size_t width, uint32_t factor, uint32_t *output);
+    static void NearestRowSSE2(const uint32_t *row, size_t width, uint32_t factor, uint32_t *output);
+    static void NearestRowAVX2(const uint32_t *row, size_t width, uint32_t factor, uint32_t *output);
+
+public:
+    //  Throws invalid_argument for a scale of 0, or an odd scale with Scale2x.
+    //  Without `vectorized` the portable kernels run, for comparing them.
+    Upscaler(uint32_t scale, ScaleFilter filter, uint8_t persistence = UpscalerConstants::NO_PERSISTENCE, bool vectorized = true);
+
+    //  Renders the screen into a buffer of `OutputWidth` by `OutputHeight` pixels.
+    void Render(const uint64_t *video, uint32_t *pixels, size_t pitch);
+
+    //  Whether a faded pixel is still lit, so rendering the same screen again changes the output.
+    bool Fading() const;
+
+    size_t OutputWidth() const { return Chip8Constants::VIDEO_WIDTH * this->scale; }
+    size_t OutputHeight() const { return Chip8Constants::VIDEO_HEIGHT * this->scale; }
+};
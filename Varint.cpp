@@ -0,0 +1,44 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#include "Varint.h"
+
+void WriteVarint(std::ostream &file, uint64_t value)
+{
+    while (value >= 0x80u)
+    {
+        file.put(static_cast<char>((value & 0x7Fu) | 0x80u));
+        value >>= 7;
+    }
+
+    file.put(static_cast<char>(value));
+}
+
+void AppendVarint(std::vector<uint8_t> &bytes, uint64_t value)
+{
+    while (value >= 0x80u)
+    {
+        bytes.push_back((value & 0x7Fu) | 0x80u);
+        value >>= 7;
+    }
+
+    bytes.push_back(value);
+}
+
+uint64_t ReadVarint(std::istream &file)
+{
+    uint64_t value = 0;
+
+    for (size_t shift = 0; shift < 64 && file.good(); shift += 7)
+    {
+        uint8_t byte = file.get();
+        value |= uint64_t(byte & 0x7Fu) << shift;
+
+        if (!(byte & 0x80u))
+        {
+            break;
+        }
+    }
+
+    return value;
+}
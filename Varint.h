@@ -0,0 +1,19 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+//  LEB128 varints, seven bits per byte and the highest bit marking that more bytes follow.
+//  The input logs and the frame recordings store their counts and distances with them.
+
+//  Writes the value to a stream, or appends it to a buffer.
+void WriteVarint(std::ostream &file, uint64_t value);
+void AppendVarint(std::vector<uint8_t> &bytes, uint64_t value);
+
+//  Reads a value, stopping at the end of the stream, so a truncated value reads as its first bytes.
+uint64_t ReadVarint(std::istream &file);
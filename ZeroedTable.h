@@ -0,0 +1,144 @@
+//  Author:     The Mister M.A.
+//  Created at: 18.10.26
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ZEROED_TABLE_MMAP 1
+#include <sys/mman.h>
+#else
+#define ZEROED_TABLE_MMAP 0
+#endif
+
+namespace ZeroedTableConstants
+{
+    //  The tables of destroyed machines kept for the next ones, for each kind of table.
+    constexpr size_t MAX_SPARE_TABLES = 64;
+
+    //  The written entries are tracked in chunks, only those are cleared before a table is reused.
+    constexpr size_t CHUNKS = 64;
+};
+
+//  A table of zeroed entries indexed by an address, mapped from anonymous memory so only the pages written are committed.
+//  A program runs out of a few pages of its memory, so a machine only holds the entries of the code it ran.
+//  Tables of destroyed machines are cleared where they were written and handed to the next ones,
+//  so a fork neither maps nor clears a whole table. The entries stay contiguous, so a lookup is a single index.
+template <typename Entry, size_t SIZE>
+class ZeroedTable
+{
+private:
+    static_assert((SIZE & (SIZE - 1)) == 0 && SIZE % ZeroedTableConstants::CHUNKS == 0, "The table is addressed by a mask in whole chunks.");
+    static_assert(std::is_trivially_copyable<Entry>::value, "An entry of zero bytes is a valid entry.");
+
+    static constexpr size_t BYTES = SIZE * sizeof(Entry);
+    static constexpr size_t CHUNK_SIZE = SIZE / ZeroedTableConstants::CHUNKS;
+
+    //  The zeroed tables waiting for a machine, shared by every thread.
+    struct Spares
+    {
+        std::mutex lock;
+        std::vector<Entry *> tables;
+    };
+
+    Entry *entries;
+
+    //  A bit for every chunk written since the table was zeroed.
+    uint64_t written{};
+
+    static Spares &SpareTables()
+    {
+        static Spares spares;
+
+        return spares;
+    }
+
+    //  Zeroes the chunks written, reading the rest never committed them.
+    void Zero()
+    {
+        for (uint64_t chunks = this->written; chunks != 0; chunks &= chunks - 1)
+        {
+            memset(static_cast<void *>(this->entries + CHUNK_SIZE * __builtin_ctzll(chunks)), 0, CHUNK_SIZE * sizeof(Entry));
+        }
+
+        this->written = 0;
+    }
+
+public:
+    ZeroedTable()
+    {
+        Spares &spares = SpareTables();
+
+        {
+            std::lock_guard<std::mutex> guard(spares.lock);
+
+            if (!spares.tables.empty())
+            {
+                this->entries = spares.tables.back();
+                spares.tables.pop_back();
+                return;
+            }
+        }
+
+#if ZEROED_TABLE_MMAP
+        void *memory = mmap(nullptr, BYTES, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (memory == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+
+        this->entries = static_cast<Entry *>(memory);
+#else
+        this->entries = new Entry[SIZE]();
+#endif
+    }
+
+    ZeroedTable(const ZeroedTable &) = delete;
+    ZeroedTable &operator=(const ZeroedTable &) = delete;
+
+    ~ZeroedTable()
+    {
+        Spares &spares = SpareTables();
+
+        this->Zero();
+
+        {
+            std::lock_guard<std::mutex> guard(spares.lock);
+
+            if (spares.tables.size() < ZeroedTableConstants::MAX_SPARE_TABLES)
+            {
+                spares.tables.push_back(this->entries);
+                return;
+            }
+        }
+
+#if ZEROED_TABLE_MMAP
+        munmap(this->entries, BYTES);
+#else
+        delete[] this->entries;
+#endif
+    }
+
+    //  The entry at the address to read, without committing its page.
+    const Entry &Peek(uint32_t address) const { return this->entries[address & (SIZE - 1)]; }
+
+    //  The entry at the address to write.
+    Entry &operator[](uint32_t address)
+    {
+        address &= SIZE - 1;
+        this->written |= uint64_t(1) << (address / CHUNK_SIZE);
+
+        return this->entries[address];
+    }
+
+    //  Zeroes every entry, which stay at the same addresses.
+    void Clear() { this->Zero(); }
+};
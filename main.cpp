@@ -1,50 +1,237 @@
+#include "Beeper.h"
 #include "Chip8.h"
+#include "FrameBuffer.h"
+#include "FrameHash.h"
+#include "FrameRecorder.h"
+#include "InputLog.h"
+#include "InputQueue.h"
 #include "PlatformInterface.h"
+#include "Upscaler.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
 
 void printVideo(uint32_t *video, size_t sizeOfVideo);
+int replaySession(const char *logFileName, const char *romFileName);
 
 int main(int argc, char *argv[])
 {
-	if (argc != 4)
+	//  Replaying a recorded session needs no window, and runs as fast as possible.
+	if (argc == 4 && !strcmp(argv[1], "--replay"))
 	{
-		printf("Usage: %s <Scale> <Delay> <ROM>\n", argv[0]);
+		return replaySession(argv[2], argv[3]);
+	}
+
+	if (argc < 4)
+	{
+		printf("Usage: %s <Scale> <Delay> <ROM> [InstructionsPerFrame] [--seed <Seed>] [--record <Log>] [--audio-buffer <Samples>] [--export <File.y4m or File>] [--cpu-render nearest|scale2x] [--phosphor <Persistence>]\n", argv[0]);
+		printf("       %s --replay <Log> <ROM>\n", argv[0]);
 		abort();
 	}
 
 	int videoScale = std::stoi(argv[1]);
 	int cycleDelay = std::stoi(argv[2]);
 	char const *romFileName = argv[3];
+	char const *recordFileName = nullptr;
+	char const *exportFileName = nullptr;
+	char const *cpuFilterName = nullptr;
+	int phosphor = UpscalerConstants::NO_PERSISTENCE;
+	uint16_t audioBufferSamples = BeeperConstants::DEFAULT_BUFFER_SAMPLES;
+
+	Chip8 chip8(romFileName);
+	InputLog inputLog;
+
+	//  Without an explicit seed the session is seeded from the clock, and the seed is recorded.
+	inputLog.seed = std::chrono::system_clock::now().time_since_epoch().count();
 
+	for (int i = 4; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+		{
+			inputLog.seed = std::stoull(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--record") && i + 1 < argc)
+		{
+			recordFileName = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--audio-buffer") && i + 1 < argc)
+		{
+			audioBufferSamples = std::stoul(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--export") && i + 1 < argc)
+		{
+			exportFileName = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--cpu-render") && i + 1 < argc)
+		{
+			cpuFilterName = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--phosphor") && i + 1 < argc)
+		{
+			phosphor = std::stoi(argv[++i]);
+
+			//  The persistence is a byte, a wider value would silently wrap around.
+			if (phosphor < 0 || phosphor > UINT8_MAX)
+			{
+				printf("Aborting, the phosphor persistence must be between 0 and %d.\n", UINT8_MAX);
+				abort();
+			}
+		}
+		else
+		{
+			//  The timers tick every frame of emulated instructions, whatever the delay between the instructions is.
+			inputLog.instructionsPerFrame = std::stoul(argv[i]);
+		}
+	}
+
+	chip8.Seed(inputLog.seed);
+	chip8.SetInstructionsPerFrame(inputLog.instructionsPerFrame);
+
+	//  The beeper outlives the platform, which stops the audio thread playing it.
+	Beeper beeper;
 	PlatformInterface platform("Chip8 - Emulator",
 							   Chip8Constants::VIDEO_WIDTH * videoScale,
 							   Chip8Constants::VIDEO_HEIGHT * videoScale,
 							   Chip8Constants::VIDEO_WIDTH,
 							   Chip8Constants::VIDEO_HEIGHT);
 
-	Chip8 chip8(romFileName);
+	//  The emulation runs on its own thread, so a slow present never delays an instruction.
+	//  The keys are handed over through the input queue, the screen through the frame buffer,
+	//  and the sound timer through the beeper.
+	std::atomic<bool> quit{false};
+	InputQueue inputs;
+	FrameBuffer frames;
 
-	int videoPitch = sizeof(chip8.video[0]) * Chip8Constants::VIDEO_WIDTH;
+	platform.OpenAudio(beeper, audioBufferSamples);
 
-	auto lastCycleTime = std::chrono::high_resolution_clock::now();
-	bool quit = false;
+	//  Rendering on the CPU when asked to, the phosphor persistence only exists on the CPU path.
+	if (cpuFilterName != nullptr || phosphor != UpscalerConstants::NO_PERSISTENCE)
+	{
+		ScaleFilter filter = (cpuFilterName != nullptr && !strcmp(cpuFilterName, "scale2x")) ? ScaleFilter::Scale2x : ScaleFilter::Nearest;
 
-	while (!quit)
+		platform.UseSoftwareRenderer(videoScale, filter, phosphor);
+	}
+
+	//  Exporting the screen at the end of every timer frame, as Y4M for `.y4m` files and as deltas otherwise.
+	std::unique_ptr<FrameRecorder> recorder;
+
+	if (exportFileName != nullptr)
 	{
-		quit = platform.ProcessInput(chip8.keypad);
+		std::string exportName = exportFileName;
+		bool y4m = exportName.size() >= 4 && exportName.compare(exportName.size() - 4, 4, ".y4m") == 0;
 
-		auto currentTime = std::chrono::high_resolution_clock::now();
-		float dt = std::chrono::duration<float, std::chrono::milliseconds::period>(currentTime - lastCycleTime).count();
+		recorder = std::make_unique<FrameRecorder>(exportFileName, y4m ? FrameFormat::Y4M : FrameFormat::Delta);
+	}
 
-		if (dt > cycleDelay)
+	std::thread emulation([&]()
+	{
+		//  Each slice runs the rest of the current timer frame at once, so waiting loops are skipped instead of executed,
+		//  then sleeps until the time its instructions were due at one every delay. The keys, the tone and the screen
+		//  are handed over between the slices.
+		const std::chrono::milliseconds instructionDelay(cycleDelay);
+		auto deadline = std::chrono::steady_clock::now();
+
+		while (!quit.load(std::memory_order_relaxed))
 		{
-			lastCycleTime = currentTime;
+			//  Applying the keys pressed and released until now, between two slices.
+			chip8.SetKeypadMask(inputs.Apply(chip8.KeypadMask(), InputQueue::Now()));
+
+			//  Recording the keypad the slice runs with, when it changed.
+			inputLog.Record(chip8.Cycles(), chip8.KeypadMask());
+
+			uint64_t slice = inputLog.instructionsPerFrame - (chip8.Cycles() % inputLog.instructionsPerFrame);
+
+			chip8.Run(slice);
+
+			beeper.SetTone(chip8.SoundTimer() != 0, InputQueue::Now());
+
+			if (recorder != nullptr && chip8.Cycles() % inputLog.instructionsPerFrame == 0)
+			{
+				recorder->Push(chip8.video, chip8.Cycles());
+			}
+
+			//  Publishing a frame only when the slice changed the screen.
+			uint32_t dirtyRows = chip8.TakeDirtyRows();
 
-			chip8.Cycle();
+			if (dirtyRows != 0)
+			{
+				frames.Publish(chip8.video, dirtyRows, chip8.Cycles());
+			}
 
-			platform.Update(chip8.video, videoPitch);
+			//  A late slice is not caught up with, the next one is timed from now.
+			deadline = std::max<std::chrono::steady_clock::time_point>(deadline + instructionDelay * slice, std::chrono::steady_clock::now());
+			std::this_thread::sleep_until(deadline);
 		}
+	});
+
+	while (!quit.load(std::memory_order_relaxed))
+	{
+		//  Presenting the newest frame, and waiting for input only when the emulation published none.
+		int timeout = platform.Update(frames) ? 0 : 1;
+
+		if (platform.ProcessInput(inputs, timeout))
+		{
+			quit.store(true, std::memory_order_relaxed);
+		}
+	}
+
+	emulation.join();
+
+	if (recorder != nullptr && recorder->Dropped() != 0)
+	{
+		printf("Dropped %zu exported frames, the disk could not keep up\n", recorder->Dropped());
+	}
+
+	if (recordFileName != nullptr)
+	{
+		inputLog.endCycle = chip8.Cycles();
+		inputLog.Save(recordFileName);
 	}
+
+#ifdef CHIP8_PROFILE
+	chip8.DumpProfile("chip8_profile.json");
+#endif
+}
+
+/***
+ *  replaySession:
+ *      Re-executes a recorded session headlessly, and prints the final screen hash and the speed.
+ *
+ *  @param logFileName  The recorded input log.
+ *  @param romFileName  The ROM the session was recorded with.
+ *
+ *  @return             The exit status.
+ ***/
+int replaySession(const char *logFileName, const char *romFileName)
+{
+	InputLog inputLog;
+	Chip8 chip8(romFileName, Chip8Engine::Threaded);
+
+	inputLog.Load(logFileName);
+
+	auto start = std::chrono::steady_clock::now();
+	inputLog.Replay(chip8);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+#ifdef CHIP8_PROFILE
+	chip8.DumpProfile("chip8_profile.json");
+#endif
+
+	//  Hashing the screen as the golden manifests do, so replays can be compared with them.
+	uint64_t hash = HashFrame(chip8.video);
+
+	printf("Replayed %llu cycles and %zu keypad changes in %.3f s (%.1f M cycles/s), screen hash %016llx\n",
+		   (unsigned long long)chip8.Cycles(),
+		   inputLog.Changes(),
+		   seconds,
+		   chip8.Cycles() / seconds / 1e6,
+		   (unsigned long long)hash);
+
+	return 0;
 }